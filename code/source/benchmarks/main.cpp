@@ -0,0 +1,1014 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Benchmarks are meaningful in release builds only - debug builds carry memory safety tracking on every number
+
+#include <chrono>
+#include <thread>
+
+namespace benchmarks {
+
+	//wall clock timer for a single measurement
+	struct stopwatch_t {
+
+		std::chrono::steady_clock::time_point m_start;
+
+		stopwatch_t() : m_start(std::chrono::steady_clock::now()) {}
+
+		inline void   reset() 			{ m_start = std::chrono::steady_clock::now(); }
+		inline double seconds() const 	{ return(std::chrono::duration<double>(std::chrono::steady_clock::now()-m_start).count()); }
+
+	};
+
+	inline void report( const char *name, double count, double secs, const char *unit ) {
+		printf("[BENCH] %-48s %14.0f %s/sec (%.3fs)\n", name, secs>0?count/secs:0.0, unit, secs);
+	}
+
+	inline void report_name( const char *type, const char *name, double count, double secs, const char *unit ) {
+		char full[64];
+		snprintf(full,sizeof(full),"%s %s",type,name);
+		report(full,count,secs,unit);
+	}
+
+	//
+	// numbers built on one thread and released on others (remote free queue)
+	//
+
+	constexpr static int REMOTEBATCH = 256;
+
+	//handoff slot between the building thread and one releasing thread
+	struct remoteslot_t {
+		biguint2048_t		*m_items[REMOTEBATCH];
+		std::atomic<int>	m_state;	//0 = empty (builder owns), 1 = full (releaser owns), 2 = stop
+		remoteslot_t() : m_items(), m_state(0) {}
+	};
+
+	void _remotereleaser( remoteslot_t *slot ) {
+		int x, state;
+		while(true) {
+			while((state=slot->m_state.load(std::memory_order_acquire))==0) std::this_thread::yield();
+			if(state==2) return;
+			for(x=0;x<REMOTEBATCH;x++) delete slot->m_items[x];
+			slot->m_state.store(0,std::memory_order_release);
+		}
+	}
+
+	void benchremotefree( int threads, int batches ) {
+
+		#if !(defined(NDEBUG) || defined(DISABLEMEMSAFETY))
+		_UNUSED_ int t=threads, b=batches;
+		printf("[BENCH] remote free handoff skipped - memory safety tracking is per thread\n");
+		#else
+		constexpr static int MAXTHREADS = 64;
+		remoteslot_t 	slots[MAXTHREADS];
+		std::thread		*releasers[MAXTHREADS];
+		stopwatch_t		sw;
+		char			name[64];
+		int 			x, y, sent = 0;
+		bool			progress;
+
+		threads = threads<MAXTHREADS?threads:MAXTHREADS;
+		for(x=0;x<threads;x++) releasers[x] = new std::thread(_remotereleaser,&slots[x]);
+
+		sw.reset();
+		while(sent<batches) {
+			progress = false;
+			for(x=0;x<threads && sent<batches;x++) {
+				if(slots[x].m_state.load(std::memory_order_acquire)!=0) continue;
+				for(y=0;y<REMOTEBATCH;y++) slots[x].m_items[y] = new biguint2048_t(y);
+				slots[x].m_state.store(1,std::memory_order_release);
+				progress = true;
+				sent++;
+			}
+			if(!progress) std::this_thread::yield();	//all releasers busy
+		}
+		for(x=0;x<threads;x++) {
+			while(slots[x].m_state.load(std::memory_order_acquire)!=0) std::this_thread::yield();
+			slots[x].m_state.store(2,std::memory_order_release);
+			releasers[x]->join();
+			delete releasers[x];
+		}
+
+		snprintf(name,sizeof(name),"remote free handoff (%d releasers)",threads);
+		report(name,(double)sent*REMOTEBATCH,sw.seconds(),"numbers");
+		#endif
+
+	}
+
+	//
+	// walking many live large numbers (bank arenas - compare against a -DBIGMATHNOARENA build)
+	//
+
+	template <typename N>
+	void benchbankwalk( const char *name, int count, int passes ) {
+		N 			**nums = new N*[count];
+		stopwatch_t	sw;
+		int 		x, y;
+
+		sw.reset();
+		for(x=0;x<count;x++) nums[x] = new N(x+1);
+		report_name(name,"create",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(y=0;y<passes;y++) {
+			for(x=0;x<count;x++) *nums[x] += *nums[(x*7919)%count];		//strided across banks
+		}
+		report_name(name,"walk",(double)count*passes,sw.seconds(),"adds");
+
+		sw.reset();
+		for(x=0;x<count;x++) delete nums[x];
+		report_name(name,"release",count,sw.seconds(),"numbers");
+		delete[] nums;
+	}
+
+	//
+	// live number count oscillating across a bank boundary (bank retention - compare against -DBIGMATHBANKKEEP=0)
+	//
+
+	template <typename N>
+	void benchbankswing( const char *name, int swing, int swings ) {
+		N 			**nums = new N*[swing];
+		stopwatch_t	sw;
+		int 		x, y;
+
+		sw.reset();
+		for(y=0;y<swings;y++) {
+			for(x=0;x<swing;x++) nums[x] = new N(x);
+			for(x=0;x<swing;x++) delete nums[x];
+		}
+		report_name(name,"bank swing",(double)swings,sw.seconds(),"swings");
+		delete[] nums;
+	}
+
+	//
+	// chained expressions through the by-value operators (move semantics - compare against -DBIGMATHNOMOVE)
+	//
+
+	template <typename N>
+	void benchchained( const char *name, int count ) {
+		N 			a, b, c, d, r;
+		stopwatch_t	sw;
+		int 		x;
+
+		a = 12345; b = 678; c = 91011; d = 1213;
+		a *= a; a *= a; a *= a; b *= a;											//spread values over several limbs
+		sw.reset();
+		for(x=0;x<count;x++) {
+			r = a*b + c*d - x;
+			r = (r+a)*3 - b;
+		}
+		report_name(name,"chained expressions",count,sw.seconds(),"exprs");
+	}
+
+	//
+	// lazy expressions against the by-value operators
+	//
+
+	template <ssize_t S>
+	void benchexpr( const char *name, int count ) {
+		biguint_t<S> a, b, c, r;
+		stopwatch_t	sw;
+		int 		x;
+
+		a = 1; b = 3; c = 5;
+		a <<= (int)S/3; b <<= (int)S/3; c <<= (int)S/2;		//a third of the width so products fit
+		r = 0;
+
+		sw.reset();
+		for(x=0;x<count;x++) { r = a*b + c; r += a*b; }
+		report_name(name,"r=a*b+c; r+=a*b (operators)",count,sw.seconds(),"pairs");
+
+		sw.reset();
+		for(x=0;x<count;x++) { r = bigexpr(a)*b + c; r += bigexpr(a)*b; }
+		report_name(name,"r=a*b+c; r+=a*b (bigexpr)",count,sw.seconds(),"pairs");
+	}
+
+	template <ssize_t S, int SZ>
+	void benchcrt( const char *name, int count ) {
+		bigmod_t<S> 	v[SZ];
+		biguint_t<S> 	p;
+		typename bigmod_t<S>::template crtsolver<S*SZ,SZ> solver;
+		stopwatch_t		sw;
+		int 			x;
+
+		p = 1; p <<= (int)S-2;
+		for(x=0;x<SZ;x++) {
+			p = biguint_t<S>::nextprime(p);
+			v[x].changemod(p);
+			v[x] = x+2;
+		}
+		sw.reset();
+		for(x=0;x<count;x++) solver.crt1(v);
+		report_name(name,"crt1",count,sw.seconds(),"solves");
+
+		sw.reset();
+		const typename bigmod_t<S>::template crtcontext<S*SZ,SZ> context(v);
+		report_name(name,"crt context build",1,sw.seconds(),"contexts");
+
+		sw.reset();
+		for(x=0;x<count;x++) context.crt(v);
+		report_name(name,"crt context",count,sw.seconds(),"solves");
+		if(context.crt(v)!=solver.crt1(v)) printf("[BENCH] %s crt context result mismatch\n",name);
+	}
+
+	//
+	// many values inverted under one modulus - per value inverse() against Montgomery's trick
+	//
+
+	template <ssize_t S>
+	void benchinvert( const char *name, int count, int passes ) {
+		bigmod_t<S> 	*v = new bigmod_t<S>[count], *w = new bigmod_t<S>[count];
+		biguint_t<S> 	p;
+		stopwatch_t		sw;
+		int 			x, y;
+
+		p = 1; p <<= (int)S-2; p = biguint_t<S>::nextprime(p);
+		v[0] = bigmod_t<S>(3,p);
+		for(x=0;x<count;x++) {
+			if(x) v[x] = bigmod_t<S>(x+3,v[0].getmodentry());
+			v[x] = v[x].pow(65537);
+		}
+
+		sw.reset();
+		for(y=0;y<passes;y++) for(x=0;x<count;x++) w[x] = v[x].inverse();
+		report_name(name,"inverse per value",(double)count*passes,sw.seconds(),"inverses");
+
+		sw.reset();
+		for(y=0;y<passes;y++) bigmod_t<S>::invertall(v,count);
+		report_name(name,"invertall",(double)count*passes,sw.seconds(),"inverses");
+		if(passes%2==0 && mpz_cmp(v[count-1].raw()[0],w[count-1].inverse().raw()[0])!=0) printf("[BENCH] %s invertall result mismatch\n",name);
+
+		delete[] v;
+		delete[] w;
+	}
+
+	//
+	// numbers packed into fixed width packet fields - decimal strings and mpz_export/mpz_import against export_to/import_from
+	//
+
+	template <ssize_t S>
+	void benchbytes( const char *name, size_t count, int passes ) {
+		constexpr static size_t W = S/8;
+		biguint_t<S> 	*v = new biguint_t<S>[count];
+		uint8_t 		*packet = new uint8_t[count*W];
+		stopwatch_t		sw;
+		size_t 			n, x, chars = 0;
+		int 			y;
+
+		for(x=0;x<count;x++) { mpz_ui_pow_ui(v[x].raw()[0],3+2*(x%50),S/8); mpz_tdiv_r_2exp(v[x].raw()[0],v[x].raw()[0],S-1); }
+
+		sw.reset();
+		for(y=0;y<passes;y++) for(x=0;x<count;x++) chars += strlen(v[x].str());
+		report_name(name,"str (truncated)",(double)count*passes,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(y=0;y<passes;y++) for(x=0;x<count;x++) {
+			n = (mpz_sizeinbase(v[x].raw()[0],2)+7)/8;
+			memset( packet+x*W, 0, W-n );
+			mpz_export( packet+x*W+W-n, 0, 1, 1, 0, 0, v[x].raw()[0] );
+		}
+		report_name(name,"mpz_export",(double)count*passes,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(y=0;y<passes;y++) mathbytes_t::exportall( std::span<uint8_t>(packet,count*W), v, count, W );
+		report_name(name,"exportall",(double)count*passes,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(y=0;y<passes;y++) for(x=0;x<count;x++) mpz_import( v[x].raw()[0], W, 1, 1, 0, 0, packet+x*W );
+		report_name(name,"mpz_import",(double)count*passes,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(y=0;y<passes;y++) mathbytes_t::importall( v, count, std::span<const uint8_t>(packet,count*W), W );
+		report_name(name,"importall",(double)count*passes,sw.seconds(),"numbers");
+		if(!chars) printf("[BENCH] %s no string output\n",name);
+
+		delete[] v;
+		delete[] packet;
+	}
+
+	//
+	// full length text of many numbers - the truncating string queue and mpz_get_str against the streaming formatter
+	//
+
+	template <ssize_t S>
+	void benchtext( const char *name, int count ) {
+		biguint_t<S> 	*v = new biguint_t<S>[count];
+		char 			*buf = new char[S/3+2];
+		std::string 	s;
+		stopwatch_t		sw;
+		size_t 			chars = 0;
+		int 			x;
+
+		for(x=0;x<count;x++) { mpz_ui_pow_ui(v[x].raw()[0],3+2*(x%50),S/8); mpz_tdiv_r_2exp(v[x].raw()[0],v[x].raw()[0],S-1); }
+
+		sw.reset();
+		for(x=0;x<count;x++) chars += strlen(v[x].str());
+		report_name(name,"str (truncated)",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(x=0;x<count;x++) chars += strlen(mpz_get_str(buf,10,v[x].raw()[0]));
+		report_name(name,"mpz_get_str decimal",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(x=0;x<count;x++) { s.clear(); chars += v[x].append(s).size(); }
+		report_name(name,"append decimal",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(x=0;x<count;x++) chars += strlen(mpz_get_str(buf,16,v[x].raw()[0]));
+		report_name(name,"mpz_get_str hex",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(x=0;x<count;x++) { s.clear(); chars += v[x].append(s,mathtext_t::HEX).size(); }
+		report_name(name,"append hex",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		for(x=0;x<count;x++) { s.clear(); chars += v[x].append(s,mathtext_t::B64).size(); }
+		report_name(name,"append base-64",count,sw.seconds(),"numbers");
+
+		sw.reset();
+		s.clear();
+		chars += mathtext_t::writeall( mathtext_t::_tostring, &s, v, count, mathtext_t::HEX );
+		report_name(name,"writeall hex",count,sw.seconds(),"numbers");
+		if(!chars) printf("[BENCH] %s no text output\n",name);
+
+		delete[] v;
+		delete[] buf;
+	}
+
+	//
+	// fixture text loaded in bulk - mpz_set_str through raw mpz_t temporaries against parsing into bank numbers
+	//
+
+	template <ssize_t S>
+	void benchparse( const char *name, int count ) {
+		const int 		bases[2] = { mathtext_t::DEC, mathtext_t::HEX };
+		biguint_t<S> 	*v = new biguint_t<S>[count];
+		std::string 	*s = new std::string[count];
+		std::string 	all;
+		stopwatch_t		sw;
+		char			label[64];
+		mpz_t 			t;
+		size_t 			n;
+		int 			x, b;
+
+		for(b=0;b<2;b++) {
+			all.clear();
+			for(x=0;x<count;x++) {
+				mpz_ui_pow_ui(v[x].raw()[0],3+2*(x%50),S/8); mpz_tdiv_r_2exp(v[x].raw()[0],v[x].raw()[0],S-1);
+				s[x].clear(); v[x].append(s[x],bases[b]);
+				all += s[x]; all += '\n';
+			}
+
+			sw.reset();
+			for(x=0;x<count;x++) { mpz_init( t ); mpz_set_str( t, s[x].c_str(), bases[b] ); mpz_set( v[x].raw()[0], t ); mpz_clear( t ); }
+			snprintf(label,sizeof(label),"mpz_set_str base %d",bases[b]);
+			report_name(name,label,count,sw.seconds(),"numbers");
+
+			sw.reset();
+			for(x=0;x<count;x++) v[x].parse( s[x].data(), s[x].size(), bases[b] );
+			snprintf(label,sizeof(label),"parse base %d",bases[b]);
+			report_name(name,label,count,sw.seconds(),"numbers");
+
+			sw.reset();
+			n = mathtext_t::readall( v, count, all.data(), all.size(), bases[b] );
+			snprintf(label,sizeof(label),"readall base %d",bases[b]);
+			report_name(name,label,count,sw.seconds(),"numbers");
+			if(n!=(size_t)count) printf("[BENCH] %s readall stopped early\n",name);
+		}
+
+		delete[] v;
+		delete[] s;
+	}
+
+	//
+	// a waypoint of blocks recombined at once - per-block crt1 and CRT context loops against the product tree batch
+	//
+
+	template <ssize_t S, int SZ>
+	void benchcrtbatch( const char *name, int blocks, int threads ) {
+		bigmod_t<S> 	*v = new bigmod_t<S>[blocks*SZ];
+		biguint_t<S*SZ>	*r = new biguint_t<S*SZ>[blocks], q;
+		biguint_t<S> 	p;
+		typename bigmod_t<S>::template crtsolver<S*SZ,SZ> solver;
+		stopwatch_t		sw;
+		char			label[64];
+		int 			x, y;
+
+		p = 1; p <<= (int)S-2;
+		for(y=0;y<SZ;y++) {
+			p = biguint_t<S>::nextprime(p);
+			v[y].changemod(p);
+			for(x=1;x<blocks;x++) v[x*SZ+y].changemod(v[y].getmodentry());
+		}
+		for(x=0;x<blocks*SZ;x++) { v[x] = x+2; v[x] = v[x].pow(65537); }
+		const typename bigmod_t<S>::template crtcontext<S*SZ,SZ> context(v);
+		const typename bigmod_t<S>::template crtbatch<S*SZ,SZ> batch(v);
+
+		sw.reset();
+		for(x=0;x<blocks;x++) r[x] = solver.crt1(v+x*SZ);
+		report_name(name,"crt1 per block",blocks,sw.seconds(),"blocks");
+		q = r[blocks-1];
+
+		sw.reset();
+		for(x=0;x<blocks;x++) r[x] = context.crt(v+x*SZ);
+		report_name(name,"crt context per block",blocks,sw.seconds(),"blocks");
+
+		sw.reset();
+		batch.crt(r,v,blocks,1);
+		report_name(name,"crt batch (1 thread)",blocks,sw.seconds(),"blocks");
+
+		sw.reset();
+		batch.crt(r,v,blocks,threads);
+		snprintf(label,sizeof(label),"crt batch (%d threads)",threads);
+		report_name(name,label,blocks,sw.seconds(),"blocks");
+		if(r[blocks-1]!=q) printf("[BENCH] %s crt batch result mismatch\n",name);
+
+		delete[] v;
+		delete[] r;
+	}
+
+	//
+	// modular reduction - multiply chains and the CRT solver on odd and even moduli (Barrett reciprocal on the modulus entry)
+	//
+
+	template <ssize_t S>
+	void benchreduce( const char *name, int count ) {
+		biguint_t<S> 	p;
+		stopwatch_t		sw;
+		int 			x, y;
+
+		for(y=0;y<2;y++) {
+			p = 1; p <<= (int)S-3; p += 1234566+y;
+			bigmod_t<S> a(3,p), r(1,p);
+			a = a.pow(1000003);
+			sw.reset();
+			for(x=0;x<count;x++) r *= a;
+			report_name(name,y?"mod multiply (odd modulus)":"mod multiply (even modulus)",count,sw.seconds(),"muls");
+		}
+	}
+
+	//
+	// modular multiply chains - plain reduction against Montgomery form (REDC)
+	//
+
+	template <ssize_t S>
+	void benchmont( const char *name, int count ) {
+		biguint_t<S> 	p;
+		stopwatch_t		sw;
+		int 			x;
+
+		p = 1; p <<= (int)S-2; p += 1234567;								//odd modulus (Montgomery form needs no prime)
+		bigmod_t<S> 	a(3,p), r(1,p);
+		bigmont_t<S> 	ma(3,p), mr(1,p);
+		a = a.pow(1000003); ma = ma.pow(1000003);								//spread values over the full width
+
+		sw.reset();
+		for(x=0;x<count;x++) r *= a;
+		report_name(name,"mod multiply (plain)",count,sw.seconds(),"muls");
+
+		sw.reset();
+		for(x=0;x<count;x++) mr *= ma;
+		report_name(name,"mod multiply (montgomery)",count,sw.seconds(),"muls");
+		if(mpz_cmp(r.raw()[0],mr.raw()[0])!=0) printf("[BENCH] %s montgomery result mismatch\n",name);
+	}
+
+	//
+	// exponentiation of a session base against a fixed modulus - mpz_powm against the fixed-base table on the modulus entry
+	//
+
+	template <ssize_t S>
+	void benchfixedbase( const char *name, int count ) {
+		biguint_t<S> 	p, e, e0;
+		stopwatch_t		sw;
+		int 			x;
+
+		p = 1; p <<= (int)S-2; p += 1234567;
+		bigmod_t<S> 	two(2,p), r, f, t(3,p);
+		t = t.pow(1000003);
+		e0 = t.raw();														//full-size exponent
+
+		sw.reset();
+		for(x=0,e=e0;x<count;x++) { e += 2; r = two.pow(e.raw()); }
+		report_name(name,"2^e (mpz_powm)",count,sw.seconds(),"pows");
+
+		sw.reset();
+		two.fixbase();
+		f = two.pow(e0.raw());												//the table grows to the exponent size on first use
+		report_name(name,"2^e table build",1,sw.seconds(),"tables");
+
+		sw.reset();
+		for(x=0,e=e0;x<count;x++) { e += 2; f = two.pow(e.raw()); }
+		report_name(name,"2^e (fixed-base table)",count,sw.seconds(),"pows");
+		if(mpz_cmp(r.raw()[0],f.raw()[0])!=0) printf("[BENCH] %s fixed-base result mismatch\n",name);
+	}
+
+	//
+	// products of independent powers on one modulus - separate pow() calls against the shared squaring chain of powprod
+	//
+
+	template <ssize_t S, int K>
+	void benchpowprod( const char *name, int count ) {
+		biguint_t<S> 	p, e[K];
+		bigmod_t<S> 	g[K], r, f;
+		const mpz_t 	*ep[K];
+		stopwatch_t		sw;
+		int 			x, y;
+
+		p = 1; p <<= (int)S-2; p += 1234567;
+		g[0] = bigmod_t<S>(3,p);
+		for(y=0;y<K;y++) {
+			if(y) g[y] = bigmod_t<S>(5+2*y,g[0].getmodentry());
+			g[y] = g[y].pow(1000003);
+			e[y] = g[y].raw();													//full-size exponents
+			ep[y] = e[y];
+		}
+
+		sw.reset();
+		for(x=0;x<count;x++) {
+			r = g[0].pow(e[0]);
+			for(y=1;y<K;y++) r *= g[y].pow(e[y]);
+		}
+		report_name(name,"prod g^e (separate pow)",count,sw.seconds(),"products");
+
+		sw.reset();
+		for(x=0;x<count;x++) f = bigmod_t<S>::powprod(g,ep,K);
+		report_name(name,"prod g^e (powprod)",count,sw.seconds(),"products");
+		if(mpz_cmp(r.raw()[0],f.raw()[0])!=0) printf("[BENCH] %s powprod result mismatch\n",name);
+	}
+
+	//
+	// per-block prover arithmetic modulo 2^S - the general power-of-two modular type against the inline limb stream type
+	//
+
+	template <ssize_t S>
+	void benchstream( const char *name, int count ) {
+		bigmod_t<-S> 	a, b, c, x, y, z, r;
+		bigstream_t<S> 	sa, sb, sc, sx, sy, sz, sr;
+		stopwatch_t		sw;
+		int 			i;
+
+		a = 3; b = 5; c = 7; x = 11; y = 13; z = 17;
+		a = a.pow(1000003); b = b.pow(1000003); c = c.pow(1000003);			//spread values over the full width
+		x = x.pow(1000003); y = y.pow(1000003); z = z.pow(1000003);
+		sa = a.raw(); sb = b.raw(); sc = c.raw(); sx = x.raw(); sy = y.raw(); sz = z.raw();
+		r = 0; sr = 0;
+
+		sw.reset();
+		for(i=0;i<count;i++) { r += a*x; r += b*y; r += c*z; }
+		report_name(name,"prover block (bigmod pow2)",count,sw.seconds(),"blocks");
+
+		sw.reset();
+		for(i=0;i<count;i++) { sr += sa*sx; sr += sb*sy; sr += sc*sz; }
+		report_name(name,"prover block (bigstream)",count,sw.seconds(),"blocks");
+		if(sr!=bigstream_t<S>(r.raw())) printf("[BENCH] %s stream result mismatch\n",name);
+	}
+
+	//
+	// OT prover kernel over an array of blocks on every supported path (ot.spec message size: pow2bits+sigbuffbits = 8390)
+	//
+
+	template <ssize_t P, ssize_t G>
+	void benchotkernel( const char *name, int count, int passes ) {
+		typedef otkernel_t<P,G> kernel_t;
+		const mp_size_t IN = kernel_t::INLIMBS, OUT = kernel_t::OUTLIMBS;
+		const otisa_t 	isas[3] = { OTISA_SCALAR, OTISA_AVX2, OTISA_AVX512 };
+		const char 		*names[3] = { "prover kernel (scalar)", "prover kernel (avx2)", "prover kernel (avx512)" };
+		mpz_t 			c[6];
+		mp_limb_t 		*in = new mp_limb_t[3*count*IN], *out = new mp_limb_t[count*OUT], *first = new mp_limb_t[count*OUT];
+		stopwatch_t		sw;
+		int 			x, y;
+		bool 			ran = false;
+
+		mpn_random(in,3*count*IN);
+		for(x=0;x<6;x++) {
+			mpz_init(c[x]);
+			mpz_random(c[x],OUT);
+		}
+		for(y=0;y<3;y++) {
+			if(!otkernel_supported(isas[y])) { report_name(name,names[y],0,0,"blocks"); continue; }
+			kernel_t k((const mpz_t*)&c[0],(const mpz_t*)&c[1],(const mpz_t*)&c[2],(const mpz_t*)&c[3],(const mpz_t*)&c[4],(const mpz_t*)&c[5],isas[y]);
+			sw.reset();
+			for(x=0;x<passes;x++) k.run(in,in+count*IN,in+2*count*IN,out,count);
+			report_name(name,names[y],(double)count*passes,sw.seconds(),"blocks");
+			if(!ran) 										mpn_copyi(first,out,count*OUT);
+			else if(mpn_cmp(first,out,count*OUT)!=0) 		printf("[BENCH] %s %s result mismatch\n",name,names[y]);
+			ran = true;
+		}
+		for(x=0;x<6;x++) mpz_clear(c[x]);
+		delete[] in;
+		delete[] out;
+		delete[] first;
+	}
+
+	//
+	// session prime sets (ot.spec genprimes(pow2bits-kbits,primebits)) - an mpz_nextprime loop against the sieve engine
+	//
+
+	void benchprimes( const char *name, size_t ceilbits, size_t primebits, int sets, int threads ) {
+		mpz_t 			p[256], t, prod;
+		gmp_randstate_t rs;
+		otprimes_t 		one(1), many(threads);
+		stopwatch_t		sw;
+		char			label[64];
+		int 			x, y, n = 0;
+
+		for(x=0;x<256;x++) mpz_init(p[x]);
+		mpz_inits(t,prod,NULL);
+		gmp_randinit_default(rs);
+
+		sw.reset();
+		for(y=0;y<sets;y++) {
+			mpz_set_ui(prod,1);
+			for(n=0;n<256;n++) {
+				mpz_urandomb(t,rs,primebits); mpz_setbit(t,primebits-1); mpz_sub_ui(t,t,1);
+				mpz_nextprime(p[n],t);
+				mpz_mul(prod,prod,p[n]);
+				if(mpz_sizeinbase(prod,2)>ceilbits) break;
+			}
+		}
+		report_name(name,"prime set (mpz_nextprime)",sets,sw.seconds(),"sets");
+
+		sw.reset();
+		for(y=0;y<sets;y++) n = one.generate(p,256,ceilbits,primebits,&rs);
+		report_name(name,"prime set (sieve, 1 thread)",sets,sw.seconds(),"sets");
+
+		sw.reset();
+		for(y=0;y<sets;y++) n = many.generate(p,256,ceilbits,primebits,&rs);
+		snprintf(label,sizeof(label),"prime set (sieve, %d threads)",threads);
+		report_name(name,label,sets,sw.seconds(),"sets");
+		if(n<1) printf("[BENCH] %s empty prime set\n",name);
+
+		for(x=0;x<256;x++) mpz_clear(p[x]);
+		mpz_clears(t,prod,NULL);
+		gmp_randclear(rs);
+	}
+
+	//
+	// immutable encoding of content into SUM/D1/D2 blocks - an mpz loop of the spec formulas against the encoding pipeline
+	//
+
+	struct encodestream_t {
+		const uint8_t 	*m_data;
+		size_t 			m_size, m_pos, m_written;
+	};
+
+	size_t encodesource( void *ctx, uint8_t *buf, size_t n ) {
+		encodestream_t *s = (encodestream_t*)ctx;
+		if(n>s->m_size-s->m_pos) n = s->m_size-s->m_pos;
+		memcpy(buf,s->m_data+s->m_pos,n);
+		s->m_pos += n;
+		return(n);
+	}
+
+	bool encodesink( void *ctx, const uint8_t *, size_t n ) {
+		((encodestream_t*)ctx)->m_written += n;
+		return(true);
+	}
+
+	void benchencode( const char *name, size_t modulusbits, size_t primebits, size_t count, int threads ) {
+		const size_t 	R = otencode_t::range(modulusbits,primebits);
+		otencode_t 		one(R), many(R,threads);
+		const size_t 	inb = one.inbytes();
+		uint8_t 		*content = new uint8_t[count*inb];
+		encodestream_t 	st = { content, count*inb, 0, 0 };
+		stopwatch_t		sw;
+		char			label[64];
+		mpz_t 			v[3], sum, d1, d2;
+		size_t 			x, y;
+		ssize_t 		n;
+
+		for(x=0;x<count*inb;x++) content[x] = (uint8_t)(x*2654435761u>>13);
+		mpz_inits(v[0],v[1],v[2],sum,d1,d2,NULL);
+
+		sw.reset();
+		for(x=0;x<count;x++) {
+			for(y=0;y<3;y++) mpz_import(v[y],inb/3,-1,1,0,0,content+x*inb+y*(inb/3));
+			mpz_setbit(v[0],R);
+			mpz_add(sum,v[0],v[1]); mpz_add(sum,sum,v[2]);
+			mpz_sub(d1,v[0],v[1]);
+			mpz_sub(d2,v[0],v[2]);
+		}
+		report_name(name,"encode (mpz)",count,sw.seconds(),"blocks");
+
+		sw.reset();
+		n = one.run(encodesource,&st,encodesink,&st);
+		report_name(name,"encode (1 thread)",count,sw.seconds(),"blocks");
+		if(n!=(ssize_t)count) printf("[BENCH] %s encoded %zd blocks\n",name,n);
+
+		st.m_pos = st.m_written = 0;
+		sw.reset();
+		n = many.run(encodesource,&st,encodesink,&st);
+		snprintf(label,sizeof(label),"encode (%d threads)",threads);
+		report_name(name,label,count,sw.seconds(),"blocks");
+		if(n!=(ssize_t)count || st.m_written!=count*one.blockbytes()) printf("[BENCH] %s encoded %zd blocks\n",name,n);
+
+		mpz_clears(v[0],v[1],v[2],sum,d1,d2,NULL);
+		delete[] content;
+	}
+
+	//
+	// encoded blocks written to a store and streamed from its mapping through the prover kernel, against blocks held in memory
+	//
+
+	void benchstore( const char *name, size_t modulusbits, size_t primebits, size_t count ) {
+		typedef otkernel_t<8342,48> kernel_t;
+		char 			path[] = "/tmp/otstoreXXXXXX";
+		otencode_t 		enc(otencode_t::range(modulusbits,primebits));
+		const size_t 	inb = enc.inbytes();
+		uint8_t 		*content = new uint8_t[count*inb];
+		mp_limb_t 		*blocks = new mp_limb_t[count*3*enc.limbs()], *out = new mp_limb_t[count*kernel_t::OUTLIMBS];
+		encodestream_t 	st = { content, count*inb, 0, 0 };
+		stopwatch_t		sw;
+		mpz_t 			c[6];
+		ssize_t 		n;
+		int 			x, fd;
+
+		for(x=0;x<(int)(count*inb);x++) content[x] = (uint8_t)(x*2654435761u>>13);
+		for(x=0;x<6;x++) { mpz_init(c[x]); mpz_random(c[x],kernel_t::OUTLIMBS); }
+		enc.encode(blocks,content,count);
+		fd = mkstemp(path);
+		if(fd>=0) close(fd);
+
+		sw.reset();
+		n = otstore_t::write(path,enc,encodesource,&st);
+		report_name(name,"store write",count,sw.seconds(),"blocks");
+		if(n!=(ssize_t)count) printf("[BENCH] %s stored %zd blocks\n",name,n);
+
+		{
+			otstore_t 	store(path,true);
+			kernel_t 	k((const mpz_t*)&c[0],(const mpz_t*)&c[1],(const mpz_t*)&c[2],(const mpz_t*)&c[3],(const mpz_t*)&c[4],(const mpz_t*)&c[5]);
+			const mp_size_t L = enc.limbs();
+
+			sw.reset();
+			k.run(blocks,blocks+L,blocks+2*L,out,count,3*L);
+			report_name(name,"kernel (memory)",count,sw.seconds(),"blocks");
+
+			sw.reset();
+			store.prefetch(0,count);
+			if(store.isopen()) k.run(store.sum(0),store.d1(0),store.d2(0),out,count,store.stride());
+			report_name(name,"kernel (store)",count,sw.seconds(),"blocks");
+			if(!store.isopen()) printf("[BENCH] %s store didn't open\n",name);
+		}
+
+		unlink(path);
+		for(x=0;x<6;x++) mpz_clear(c[x]);
+		delete[] content;
+		delete[] blocks;
+		delete[] out;
+	}
+
+	//
+	// prover responses for a store of blocks - the engine on one thread and on several, streamed to a counting sink
+	//
+
+	void benchprover( const char *name, size_t modulusbits, size_t primebits, size_t count, int threads ) {
+		typedef otprover_t<8342,48> prover_t;
+		char 			path[] = "/tmp/otproverXXXXXX";
+		otencode_t 		enc(otencode_t::range(modulusbits,primebits));
+		const size_t 	inb = enc.inbytes();
+		uint8_t 		*content = new uint8_t[count*inb];
+		encodestream_t 	st = { content, count*inb, 0, 0 };
+		stopwatch_t		sw;
+		char			label[64];
+		mpz_t 			c[6];
+		const mpz_t 	*cp[6];
+		ssize_t 		n;
+		int 			x, fd;
+
+		for(x=0;x<(int)(count*inb);x++) content[x] = (uint8_t)(x*2654435761u>>13);
+		for(x=0;x<6;x++) { mpz_init(c[x]); mpz_random(c[x],prover_t::OUTLIMBS); cp[x] = &c[x]; }
+		fd = mkstemp(path);
+		if(fd>=0) close(fd);
+		n = otstore_t::write(path,enc,encodesource,&st);
+		if(n!=(ssize_t)count) printf("[BENCH] %s stored %zd blocks\n",name,n);
+
+		{
+			otstore_t 	store(path,true);
+			prover_t 	one(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5]), many(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5],threads);
+
+			st.m_written = 0;
+			sw.reset();
+			n = one.stream(store,0,count,encodesink,&st);
+			report_name(name,"prover (1 thread)",count,sw.seconds(),"blocks");
+
+			sw.reset();
+			n = many.stream(store,0,count,encodesink,&st);
+			snprintf(label,sizeof(label),"prover (%d threads)",threads);
+			report_name(name,label,count,sw.seconds(),"blocks");
+			if(n!=(ssize_t)count || st.m_written!=2*count*prover_t::OUTLIMBS*sizeof(mp_limb_t)) printf("[BENCH] %s answered %zd blocks\n",name,n);
+		}
+
+		unlink(path);
+		for(x=0;x<6;x++) mpz_clear(c[x]);
+		delete[] content;
+	}
+
+	//
+	// proxy accumulators for many relayed streams - an mpz multiply-accumulate per polynomial against the verifier engine,
+	//	then a waypoint of challenges on one thread and on several
+	//
+
+	template <ssize_t P, ssize_t G>
+	void benchverify( const char *name, int streams, int polys, int responses, int threads ) {
+		typedef otverifier_t<P,G> verifier_t;
+		const mp_size_t OUT = verifier_t::OUTLIMBS;
+		mp_limb_t 		*resp = new mp_limb_t[responses*OUT], *polylimbs = new mp_limb_t[polys*3*OUT];
+		otpoly_t 		*poly = new otpoly_t[polys];
+		const otpoly_t 	**sel = new const otpoly_t*[polys];
+		const mpz_t 	**coefs = new const mpz_t*[6*streams];
+		int 			*ids = new int[streams];
+		bool 			*ok = new bool[streams];
+		mpz_t 			*acc = new mpz_t[streams*polys], c[6], b;
+		unsigned long 	*X = new unsigned long[streams*polys];
+		verifier_t 		one(streams,polys), many(streams,polys,threads);
+		stopwatch_t		sw;
+		char			label[64];
+		int 			s, x, j, passed = 0;
+
+		mpn_random(resp,responses*OUT);
+		mpn_random(polylimbs,polys*3*OUT);
+		for(x=0;x<6;x++) { mpz_init(c[x]); mpz_random(c[x],OUT); }
+		for(j=0;j<polys;j++) {
+			poly[j].m_modulus = 16777213; poly[j].m_x = 1000003+j;
+			poly[j].m_sum = polylimbs+3*j*OUT; poly[j].m_d1 = poly[j].m_sum+OUT; poly[j].m_d2 = poly[j].m_d1+OUT;
+			poly[j].m_limbs = OUT;
+			sel[j] = &poly[j];
+		}
+		for(s=0;s<streams;s++) {
+			ids[s] = s;
+			for(x=0;x<6;x++) coefs[6*s+x] = (const mpz_t*)&c[x];
+		}
+
+		for(x=0;x<streams*polys;x++) { mpz_init2(acc[x],P+G+GMP_NUMB_BITS); X[x] = 1; }
+		sw.reset();																//streams interleaved as relayed
+		for(x=0;x<responses;x++) {
+			mpz_roinit_n(b,resp+x*OUT,OUT);
+			for(s=0;s<streams;s++)
+				for(j=0;j<polys;j++) {
+					X[s*polys+j] = X[s*polys+j]*poly[j].m_x%poly[j].m_modulus;
+					mpz_addmul_ui(acc[s*polys+j],b,X[s*polys+j]);
+					mpz_fdiv_r_2exp(acc[s*polys+j],acc[s*polys+j],P+G);
+				}
+		}
+		snprintf(label,sizeof(label),"accumulate x%d (mpz)",polys);
+		report_name(name,label,(double)streams*responses,sw.seconds(),"responses");
+
+		sw.reset();
+		for(s=0;s<streams;s++) one.open(s,sel);
+		for(x=0;x<responses;x++)
+			for(s=0;s<streams;s++) one.add(s,resp+x*OUT);
+		snprintf(label,sizeof(label),"accumulate x%d (verifier)",polys);
+		report_name(name,label,(double)streams*responses,sw.seconds(),"responses");
+
+		for(s=0;s<streams;s++) {
+			many.open(s,sel);
+			many.addall(s,resp,responses);
+		}
+		sw.reset();
+		passed += one.checkall(ids,coefs,streams,ok);
+		report_name(name,"challenges (1 thread)",streams,sw.seconds(),"streams");
+
+		sw.reset();
+		passed += many.checkall(ids,coefs,streams,ok);
+		snprintf(label,sizeof(label),"challenges (%d threads)",threads);
+		report_name(name,label,streams,sw.seconds(),"streams");
+		if(passed) printf("[BENCH] %s random challenges passed\n",name);
+
+		for(x=0;x<streams*polys;x++) mpz_clear(acc[x]);
+		for(x=0;x<6;x++) mpz_clear(c[x]);
+		delete[] X;
+		delete[] resp;
+		delete[] polylimbs;
+		delete[] poly;
+		delete[] sel;
+		delete[] coefs;
+		delete[] ids;
+		delete[] ok;
+		delete[] acc;
+	}
+
+	//
+	// signature polynomials of a store's waypoints - a pass per polynomial on mpz against the fused builder
+	//
+
+	void benchpolys( const char *name, size_t modulusbits, size_t primebits, size_t blocks, int waypoints, int polys, int threads ) {
+		char 			path[] = "/tmp/otpolysXXXXXX";
+		const size_t 	count = blocks*waypoints;
+		otencode_t 		enc(otencode_t::range(modulusbits,primebits));
+		const size_t 	inb = enc.inbytes();
+		uint8_t 		*content = new uint8_t[count*inb];
+		uint32_t 		*m = new uint32_t[polys], *xv = new uint32_t[polys];
+		encodestream_t 	st = { content, count*inb, 0, 0 };
+		stopwatch_t		sw;
+		char			label[64];
+		mpz_t 			sum, v;
+		unsigned long 	X;
+		ssize_t 		n;
+		size_t 			i;
+		int 			w, j, k, fd;
+
+		for(i=0;i<count*inb;i++) content[i] = (uint8_t)(i*2654435761u>>13);
+		for(j=0;j<polys;j++) { m[j] = 16777213-2*j; xv[j] = 1000003+j; }
+		fd = mkstemp(path);
+		if(fd>=0) close(fd);
+		n = otstore_t::write(path,enc,encodesource,&st);
+		if(n!=(ssize_t)count) printf("[BENCH] %s stored %zd blocks\n",name,n);
+		mpz_init(sum);
+
+		{
+			otstore_t 	store(path,true);
+			otpolys_t 	one(store,blocks,m,xv,polys), many(store,blocks,m,xv,polys,threads);
+
+			sw.reset();
+			for(w=0;w<waypoints;w++)
+				for(j=0;j<polys;j++)
+					for(k=0;k<3;k++) {
+						mpz_set_ui(sum,0);
+						for(i=0,X=xv[j];i<blocks;i++,X=X*xv[j]%m[j]) mpz_addmul_ui(sum,store.value(v,w*blocks+i,k),X);
+					}
+			snprintf(label,sizeof(label),"waypoint x%d (mpz)",polys);
+			report_name(name,label,waypoints,sw.seconds(),"waypoints");
+
+			sw.reset();
+			one.build(0,waypoints);
+			snprintf(label,sizeof(label),"waypoint x%d (1 thread)",polys);
+			report_name(name,label,waypoints,sw.seconds(),"waypoints");
+
+			sw.reset();
+			many.build(0,waypoints);
+			snprintf(label,sizeof(label),"waypoint x%d (%d threads)",polys,threads);
+			report_name(name,label,waypoints,sw.seconds(),"waypoints");
+
+			sw.reset();
+			for(w=0;w<waypoints;w++) many.polys(w);
+			report_name(name,"waypoint (cached)",waypoints,sw.seconds(),"waypoints");
+			if(many.built()!=(size_t)waypoints || mpn_cmp(one.polys(0)[0].m_sum,many.polys(0)[0].m_sum,one.limbs())!=0) printf("[BENCH] %s polynomial mismatch\n",name);
+		}
+
+		unlink(path);
+		mpz_clear(sum);
+		delete[] content;
+		delete[] m;
+		delete[] xv;
+	}
+
+	void start() {
+		benchremotefree(1,20000);
+		benchremotefree(4,20000);
+		benchbankwalk<biguint8192_t>("uint8192",20000,100);
+		benchbankwalk<bigfrac16384_t>("frac16384",5000,100);
+		benchchained<biguint2048_t>("uint2048",500000);
+		benchchained<bigint8192_t>("int8192",200000);
+		benchchained<bigfrac2048_t>("frac2048",200000);
+		benchexpr<2048>("uint2048",300000);
+		benchexpr<8192>("uint8192",100000);
+		benchinvert<2048>("mod2048",1000,10);
+		benchbytes<8384>("uint8384",1000,50);
+		benchtext<8320>("uint8320",5000);
+		benchtext<65536>("uint65536",100);
+		benchparse<8320>("uint8320",5000);
+		benchcrt<2048,8>("mod2048 x8",2000);
+		benchcrt<2048,32>("mod2048 x32",200);
+		benchcrtbatch<2048,8>("mod2048 x8",3000,4);
+		benchcrtbatch<2048,32>("mod2048 x32",1000,4);
+		benchreduce<2048>("mod2048",500000);
+		benchreduce<8320>("mod8320",50000);
+		benchmont<2048>("mod2048",500000);
+		benchmont<4096>("mod4096",200000);
+		benchmont<8320>("mod8320",50000);
+		benchfixedbase<8320>("mod8320",40);
+		benchpowprod<8320,3>("mod8320x3",10);
+		benchpowprod<8320,8>("mod8320x8",4);
+		benchstream<2048>("stream2048",500000);
+		benchstream<8192>("stream8192",50000);
+		benchotkernel<8342,48>("ot8390",256,40);
+		benchprimes("ot8342 128",8342-128,128,20,4);
+		benchprimes("ot8342 1024",8342-128,1024,4,4);
+		benchencode("ot8320 128",8320,128,20000,4);
+		benchstore("ot8320 128",8320,128,4000);
+		benchprover("ot8320 128",8320,128,4000,4);
+		benchverify<8342,48>("ot8390",2000,6,30,4);
+		benchpolys("ot8320 128",8320,128,3000,4,12,4);
+		benchbankswing<biguint8192_t>("uint8192",BIGMATHBANKSIZE*2,2000);
+		benchbankswing<bigfrac16384_t>("frac16384",BIGMATHBANKSIZE*2,500);
+	}
+
+}
@@ -21,6 +21,7 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 
 //#define DISABLEMEMSAFETY
 #define TESTUNITS
+//#define BENCHMARKS
 
 #include <memory.h>
 #include <stdio.h>
@@ -29,9 +30,19 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 #include "./util/memsafety.h"
 #include "./util/linkedlist.h"
 #include "./util/bigmath.h"
+#include "./ot/otkernel.h"
+#include "./ot/otprimes.h"
+#include "./ot/otencode.h"
+#include "./ot/otstore.h"
+#include "./ot/otprover.h"
+#include "./ot/otverify.h"
+#include "./ot/otpolys.h"
 #ifdef TESTUNITS
 #include "./unit.tests/main.cpp"
 #endif
+#ifdef BENCHMARKS
+#include "./benchmarks/main.cpp"
+#endif
 
 #ifdef TESTUNITS
 int appmain(_UNUSED_ int argc, _UNUSED_ char **argv)
@@ -40,11 +51,19 @@ int appmain(_UNUSED_ int argc, _UNUSED_ char **argv)
 
 	printf("Unit tests successful.\n");
 
+	#ifdef BENCHMARKS
+	benchmarks::start();
+	#endif
+
 	return(0);
 }
 #else
 int appmain(_UNUSED_ int argc, _UNUSED_ char **argv)
 {
+	#ifdef BENCHMARKS
+	benchmarks::start();
+	#endif
+
 	printf("Done.");
 	return(0);
 }
@@ -0,0 +1,290 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Immutable encoding of specifications/immutable.encoding.spec - every block takes three content pieces Ti, BiL and BiR
+//	(one-time pad encrypted by the caller) of rangebits bits and stores
+//		SUM = (Ti+R) + BiL + BiR
+//		D1  = (Ti+R) - BiL
+//		D2  = (Ti+R) - BiR
+//	with R = 2^rangebits, the encoding range boost that keeps D1 and D2 positive (DATA[block][0] in examples/python.v3).
+//	Content is read as back to back pieces of rangebits/8 little endian bytes in Ti, BiL, BiR order, a short last block is
+//	zero padded. A block is written as SUM, D1 and D2 of limbs() little endian limbs each (rangebits+2 bits rounded up),
+//	the fixed stride layout otkernel_t reads with instride 3*limbs(). Streams run as a pipeline over a ring of chunk
+//	buffers: a reader thread fills chunks from the source, the encoding threads take them in turn and the calling thread
+//	writes them to the sink in order, so memory stays at SLOTS chunks per encoding thread whatever the content size.
+
+#ifndef OTENCODE_H
+#define OTENCODE_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include "../util/bigmath.h"
+
+namespace _otencode {
+
+	constexpr static int SLOTS = 2;		//chunk buffers per encoding thread (one encoding while the other is read or written)
+
+	enum { FREE, FILLED, ENCODED };
+
+	struct slot_t {
+		uint8_t 	*m_in;			//chunk content
+		mp_limb_t 	*m_out;			//chunk blocks
+		size_t 		m_seq;			//chunk number
+		size_t 		m_blocks;
+		int 		m_state;
+	};
+
+	inline size_t fileread( void *ctx, uint8_t *buf, size_t n ) 		{ return(fread(buf,1,n,(FILE*)ctx)); }
+	inline bool   filewrite( void *ctx, const uint8_t *buf, size_t n ) 	{ return(fwrite(buf,1,n,(FILE*)ctx)==n); }
+
+}
+
+struct otencode_t {
+
+	typedef size_t 	(*source_t)( void *ctx, uint8_t *buf, size_t n );			//up to n bytes into buf, 0 at the end of the content
+	typedef bool 	(*sink_t)( void *ctx, const uint8_t *buf, size_t n );		//false on a write error (stops the pipeline)
+
+	size_t 		m_rangebits;	//content piece bits (the boost is 2^rangebits)
+	size_t 		m_piecebytes;	//content bytes per piece
+	mp_size_t 	m_limbs;		//limbs per SUM/D1/D2 value
+	size_t 		m_chunk;		//blocks per pipeline chunk
+	int 		m_threads;		//encoding threads
+
+	//
+	// routines
+	//
+
+		//pipeline state shared by the reader, the encoding threads and the writer
+		struct _pipe_t {
+			std::mutex 					m_lock;
+			std::condition_variable 	m_cv;
+			_otencode::slot_t 			*m_slots;
+			size_t 						m_nslots;
+			size_t 						m_next;			//next chunk to encode
+			size_t 						m_end;			//chunks in the content (known once the source runs dry)
+			bool 						m_stop;			//sink failed
+		};
+
+		//count blocks of content at in to out, scratch holds 3*m_limbs limbs
+		inline void _encode( mp_limb_t *out, const uint8_t *in, size_t count, mp_limb_t *scratch ) const {
+			const mp_size_t n = m_limbs;
+			mp_limb_t 		*t = scratch, *l = t+n, *r = l+n, *sum, *d1, *d2;
+			size_t 			x;
+			for(x=0;x<count;x++,in+=3*m_piecebytes,out+=3*n) {
+				sum = out; d1 = out+n; d2 = out+2*n;
+				mpn_zero( scratch, 3*n );
+				mathbytes_t::get( t, n, in, 				 m_piecebytes, mathbytes_t::LITTLE );
+				mathbytes_t::get( l, n, in+m_piecebytes, 	 m_piecebytes, mathbytes_t::LITTLE );
+				mathbytes_t::get( r, n, in+2*m_piecebytes, m_piecebytes, mathbytes_t::LITTLE );
+				t[m_rangebits/GMP_NUMB_BITS] |= (mp_limb_t)1<<(m_rangebits%GMP_NUMB_BITS);		//Ti+R
+				mpn_add_n( sum, t, l, n );
+				mpn_add_n( sum, sum, r, n );
+				mpn_sub_n( d1, t, l, n );
+				mpn_sub_n( d2, t, r, n );
+			}
+		}
+
+		//native limbs to the little endian stream order
+		inline static void _order( mp_limb_t *l, size_t n ) {
+			#if __BYTE_ORDER__!=__ORDER_LITTLE_ENDIAN__
+			size_t x;
+			for(x=0;x<n;x++) l[x] = mathbytes_t::_swap( l[x] );
+			#else
+			(void)l; (void)n;
+			#endif
+		}
+
+		//up to m_chunk blocks of content into buf (zero padded to whole blocks), returns the bytes read
+		inline size_t _fill( uint8_t *buf, source_t source, void *ctx ) const {
+			const size_t 	want = m_chunk*inbytes();
+			size_t 			got = 0, r;
+			while(got<want && (r=source(ctx,buf+got,want-got))>0) got += r;
+			if(got%inbytes()) memset( buf+got, 0, inbytes()-got%inbytes() );
+			return(got);
+		}
+
+		inline void _reader( _pipe_t *p, source_t source, void *ctx ) const {
+			_otencode::slot_t 	*s;
+			size_t 				seq, got;
+			for(seq=0;;seq++) {
+				s = &p->m_slots[seq%p->m_nslots];
+				{
+					std::unique_lock<std::mutex> lock(p->m_lock);
+					p->m_cv.wait( lock, [&]{ return(p->m_stop || s->m_state==_otencode::FREE); } );
+					if(p->m_stop) return;
+				}
+				got = _fill( s->m_in, source, ctx );
+				std::lock_guard<std::mutex> lock(p->m_lock);
+				if(got) {
+					s->m_seq = seq;
+					s->m_blocks = (got+inbytes()-1)/inbytes();
+					s->m_state = _otencode::FILLED;
+				}
+				if(got<m_chunk*inbytes()) p->m_end = seq+(got?1:0);
+				p->m_cv.notify_all();
+				if(got<m_chunk*inbytes()) return;
+			}
+		}
+
+		inline void _worker( _pipe_t *p, mp_limb_t *scratch ) const {
+			_otencode::slot_t 	*s;
+			while(true) {
+				{
+					std::unique_lock<std::mutex> lock(p->m_lock);
+					p->m_cv.wait( lock, [&]{
+						s = &p->m_slots[p->m_next%p->m_nslots];
+						return(p->m_stop || p->m_next>=p->m_end || (s->m_state==_otencode::FILLED && s->m_seq==p->m_next));
+					} );
+					if(p->m_stop || p->m_next>=p->m_end) return;
+					p->m_next++;
+				}
+				_encode( s->m_out, s->m_in, s->m_blocks, scratch );
+				_order( s->m_out, s->m_blocks*3*m_limbs );
+				std::lock_guard<std::mutex> lock(p->m_lock);
+				s->m_state = _otencode::ENCODED;
+				p->m_cv.notify_all();
+			}
+		}
+
+		//threads<=1 - read, encode and write one chunk at a time on the calling thread
+		inline ssize_t _serial( source_t source, void *sctx, sink_t sink, void *dctx ) const {
+			uint8_t 	*in = new uint8_t[m_chunk*inbytes()];
+			mp_limb_t 	*out = new mp_limb_t[m_chunk*3*m_limbs], *scratch = new mp_limb_t[3*m_limbs];
+			ssize_t 	blocks = 0;
+			size_t 		got, n;
+			do {
+				got = _fill( in, source, sctx );
+				n = (got+inbytes()-1)/inbytes();
+				if(!n) break;
+				_encode( out, in, n, scratch );
+				_order( out, n*3*m_limbs );
+				if(!sink(dctx,(const uint8_t*)out,n*blockbytes())) { blocks = -1; break; }
+				blocks += (ssize_t)n;
+			} while(got==m_chunk*inbytes());
+			delete[] in;
+			delete[] out;
+			delete[] scratch;
+			return(blocks);
+		}
+
+	//rangebits of pieces (at least 8), threads encoding in the pipeline and blocks per chunk
+	inline explicit otencode_t( size_t rangebits, int threads = 1, size_t chunk = 256 ) :
+			m_rangebits(rangebits<8?8:rangebits), m_piecebytes(m_rangebits/8),
+			m_limbs((mp_size_t)((m_rangebits+2+GMP_NUMB_BITS-1)/GMP_NUMB_BITS)), m_chunk(chunk<1?1:chunk), m_threads(threads<1?1:threads) {}
+
+	//encoding range bits for a modulus and prime size - encodingrange in examples/python.v3
+	inline static size_t range( size_t modulusbits, size_t primebits ) {
+		return(modulusbits-primebits-(modulusbits-primebits)/primebits*2);
+	}
+
+	inline mp_size_t 	limbs() 		const { return(m_limbs); }
+	inline size_t 		inbytes() 		const { return(3*m_piecebytes); }							//content per block
+	inline size_t 		blockbytes() 	const { return(3*(size_t)m_limbs*mathbytes_t::LIMBBYTES); }	//SUM, D1 and D2 per block
+
+	//count blocks of content at in (count*inbytes() bytes) to out (count*3*limbs() native limbs)
+	inline void encode( mp_limb_t *out, const uint8_t *in, size_t count ) const {
+		mp_limb_t *scratch = new mp_limb_t[3*m_limbs];
+		_encode( out, in, count, scratch );
+		delete[] scratch;
+	}
+
+	//every block of the source to the sink, returns the blocks written or -1 when the sink fails
+	inline ssize_t run( source_t source, void *sctx, sink_t sink, void *dctx ) const {
+		_pipe_t 			p;
+		std::thread 		*reader, **workers;
+		mp_limb_t 			**scratch;
+		_otencode::slot_t 	*s;
+		ssize_t 			blocks = 0;
+		size_t 				seq, x;
+		bool 				ok = true;
+		if(m_threads<=1) return(_serial( source, sctx, sink, dctx ));
+		p.m_nslots = (size_t)m_threads*_otencode::SLOTS;
+		p.m_slots = new _otencode::slot_t[p.m_nslots];
+		p.m_next = 0;
+		p.m_end = ~(size_t)0;
+		p.m_stop = false;
+		for(x=0;x<p.m_nslots;x++) {
+			p.m_slots[x].m_in = new uint8_t[m_chunk*inbytes()];
+			p.m_slots[x].m_out = new mp_limb_t[m_chunk*3*m_limbs];
+			p.m_slots[x].m_seq = p.m_slots[x].m_blocks = 0;
+			p.m_slots[x].m_state = _otencode::FREE;
+		}
+		scratch = new mp_limb_t*[m_threads];
+		workers = new std::thread*[m_threads];
+		for(x=0;x<(size_t)m_threads;x++) {
+			scratch[x] = new mp_limb_t[3*m_limbs];
+			workers[x] = new std::thread( &otencode_t::_worker, this, &p, scratch[x] );
+		}
+		reader = new std::thread( &otencode_t::_reader, this, &p, source, sctx );
+		for(seq=0;ok;seq++) {										//chunks leave in order
+			s = &p.m_slots[seq%p.m_nslots];
+			{
+				std::unique_lock<std::mutex> lock(p.m_lock);
+				p.m_cv.wait( lock, [&]{ return(seq>=p.m_end || (s->m_state==_otencode::ENCODED && s->m_seq==seq)); } );
+				if(seq>=p.m_end) break;
+			}
+			ok = sink( dctx, (const uint8_t*)s->m_out, s->m_blocks*blockbytes() );
+			blocks += (ssize_t)s->m_blocks;
+			std::lock_guard<std::mutex> lock(p.m_lock);
+			if(ok) 	s->m_state = _otencode::FREE;
+			else 	p.m_stop = true;
+			p.m_cv.notify_all();
+		}
+		reader->join();
+		delete reader;
+		for(x=0;x<(size_t)m_threads;x++) {
+			workers[x]->join();
+			delete workers[x];
+			delete[] scratch[x];
+		}
+		delete[] workers;
+		delete[] scratch;
+		for(x=0;x<p.m_nslots;x++) {
+			delete[] p.m_slots[x].m_in;
+			delete[] p.m_slots[x].m_out;
+		}
+		delete[] p.m_slots;
+		return(ok?blocks:-1);
+	}
+
+	//content to block stream, -1 when either fails (a read error is not the end of the content)
+	inline ssize_t run( FILE *in, FILE *out ) const {
+		const ssize_t blocks = run( _otencode::fileread, in, _otencode::filewrite, out );
+		return(ferror(in)?-1:blocks);
+	}
+
+	//content file to block file, -1 when either can't be opened, read or written
+	inline ssize_t run( const char *inpath, const char *outpath ) const {
+		FILE 	*in = fopen( inpath, "rb" ), *out = in?fopen( outpath, "wb" ):0;
+		ssize_t blocks = -1;
+		if(out) {
+			blocks = run( in, out );
+			if(fclose(out)!=0) blocks = -1;
+		}
+		if(in) fclose( in );
+		return(blocks);
+	}
+
+};
+
+#endif
@@ -0,0 +1,369 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Streaming prover kernel for the "Granular optimizations" section of specifications/ot.spec (P = pow2bits, G = sigbuffbits)
+//		Bp =  ( B0*SUM + B1*D1 + B2*D2 )			& p2mask
+//		Bf = (( F0*SUM + F1*D1 + F2*D2 ) >> P)		& p2sigmask
+//		B  =  ( sigpad(Bp) + Bf )					& p2sigmask
+//	Blocks are fixed-stride little-endian limb arrays (SUM/D1/D2 values < 2^P, bits above P are ignored), responses are
+//	OUTLIMBS limbs each. The six coefficients are split once into digit vectors for the life of the request. The SIMD paths
+//	then run one block per lane and sum each digit column of all six products without carries (digits leave 12 spare bits):
+//		OTISA_SCALAR	one block at a time on GMP mpn products
+//		OTISA_AVX2		4 blocks per pass, 26 bit digits (vpmuludq)
+//		OTISA_AVX512	8 blocks per pass, 52 bit digits (vpmadd52luq/vpmadd52huq)
+//	Every path is exact, so responses are bit-identical whichever one runs. By default the 52 bit path runs where the CPU has
+//	it and the scalar path otherwise - the 26 bit path does four times the digit products and trails GMP's own multiply at
+//	spec sizes, so it only runs when asked for (CPUs without IFMA but with a slow GMP build).
+
+#ifndef OTKERNEL_H
+#define OTKERNEL_H
+
+#include "../util/bigmath.h"
+
+//to disable the SIMD paths (scalar GMP path only)
+//define OTKERNELNOSIMD
+
+#if !defined(OTKERNELNOSIMD) && !defined(__x86_64__)
+#define OTKERNELNOSIMD
+#endif
+
+#ifndef OTKERNELNOSIMD
+#include <immintrin.h>
+#endif
+
+enum otisa_t { OTISA_SCALAR = 0, OTISA_AVX2 = 1, OTISA_AVX512 = 2 };
+
+namespace _otkernel {
+
+	constexpr static int LANES[3] = { 1, 4, 8 };
+	constexpr static int RADIX[3] = { GMP_NUMB_BITS, 26, 52 };
+
+	inline bool supported( otisa_t isa ) {
+		#ifdef OTKERNELNOSIMD
+		return(isa==OTISA_SCALAR);
+		#else
+		switch(isa) {
+			case OTISA_AVX2: 	return(__builtin_cpu_supports("avx2"));
+			case OTISA_AVX512: 	return(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma"));
+			default: 			return(true);
+		}
+		#endif
+	}
+
+	inline otisa_t best() {
+		return(supported(OTISA_AVX512)?OTISA_AVX512:OTISA_SCALAR);
+	}
+
+	//clear bits >= bits
+	inline void mask( mp_limb_t *l, mp_size_t nl, size_t bits ) {
+		mp_size_t x = bits/GMP_NUMB_BITS;
+		if(x>=nl) return;
+		l[x] &= (((mp_limb_t)1)<<(bits%GMP_NUMB_BITS))-1;
+		for(x++;x<nl;x++) l[x] = 0;
+	}
+
+	//split the low bits of a limb array into nd radix 2^r digits d[0], d[stride], ...
+	inline void todigits( uint64_t *d, int stride, int nd, int r, const mp_limb_t *l, mp_size_t nl, size_t bits ) {
+		const uint64_t m = (((uint64_t)1)<<r)-1;
+		size_t p;
+		mp_size_t i;
+		uint64_t v;
+		int j, o;
+		for(j=0;j<nd;j++) {
+			p = (size_t)j*r;
+			i = p/GMP_NUMB_BITS;
+			o = p%GMP_NUMB_BITS;
+			v = 0;
+			if(p<bits && i<nl) {
+				v = l[i]>>o;
+				if(o+r>GMP_NUMB_BITS && i+1<nl) v |= l[i+1]<<(GMP_NUMB_BITS-o);
+				v &= m;
+				if(p+r>bits) v &= (((uint64_t)1)<<(bits-p))-1;
+			}
+			d[(size_t)j*stride] = v;
+		}
+	}
+
+	//join nd normalized radix 2^r digits back into nl limbs (higher digits are dropped)
+	inline void fromdigits( mp_limb_t *l, mp_size_t nl, const uint64_t *d, int stride, int nd, int r ) {
+		size_t p;
+		mp_size_t i;
+		uint64_t v;
+		int j, o;
+		mpn_zero( l, nl );
+		for(j=0;j<nd;j++) {
+			p = (size_t)j*r;
+			i = p/GMP_NUMB_BITS;
+			o = p%GMP_NUMB_BITS;
+			if(i>=nl) break;
+			v = d[(size_t)j*stride];
+			l[i] |= v<<o;
+			if(o+r>GMP_NUMB_BITS && i+1<nl) l[i+1] |= v>>(GMP_NUMB_BITS-o);
+		}
+	}
+
+#ifndef OTKERNELNOSIMD
+
+	//Column sums for one pass of lanes. cd holds the coefficient digits (B0,B1,B2 nd each then F0,F1,F2 nfd each), in the
+	//	lane-interleaved block digits (SUM,D1,D2 nd vectors each, nd+2 apart with a zero vector either side). Writes nd digit
+	//	vectors of the B products to tb and ncol+1 digit vectors of the F products to tf, all normalized.
+
+	__attribute__((target("avx2")))
+	inline void columns_avx2( const uint64_t *cd, int nd, int nfd, int ncol, const uint64_t *in, uint64_t *tb, uint64_t *tf ) {
+		const __m256i 	m = _mm256_set1_epi64x((1ll<<26)-1);
+		const uint64_t 	*cb = cd, *cf = cd+3*nd;
+		const uint64_t 	*s1 = in+(nd+2)*4, *s2 = in+2*(nd+2)*4;
+		__m256i 		f0, f1, f2, b0, b1, b2, s, t, u, v, carryb, carryf;
+		int 			i, j, k, lo, hi;
+
+		carryb = carryf = _mm256_setzero_si256();
+		for(k=0;k<ncol;k++) {
+			f0 = f1 = f2 = b0 = b1 = b2 = _mm256_setzero_si256();
+			lo = k<nd?0:k-nd+1;
+			hi = k<nfd?k:nfd-1;
+			if(k<nd) {
+				for(i=lo;i<=hi;i++) {
+					j = k-i;
+					s = _mm256_loadu_si256((const __m256i*)(in+j*4));
+					t = _mm256_loadu_si256((const __m256i*)(s1+j*4));
+					u = _mm256_loadu_si256((const __m256i*)(s2+j*4));
+					f0 = _mm256_add_epi64(f0,_mm256_mul_epu32(s,_mm256_set1_epi64x(cf[i])));
+					f1 = _mm256_add_epi64(f1,_mm256_mul_epu32(t,_mm256_set1_epi64x(cf[nfd+i])));
+					f2 = _mm256_add_epi64(f2,_mm256_mul_epu32(u,_mm256_set1_epi64x(cf[2*nfd+i])));
+					b0 = _mm256_add_epi64(b0,_mm256_mul_epu32(s,_mm256_set1_epi64x(cb[i])));
+					b1 = _mm256_add_epi64(b1,_mm256_mul_epu32(t,_mm256_set1_epi64x(cb[nd+i])));
+					b2 = _mm256_add_epi64(b2,_mm256_mul_epu32(u,_mm256_set1_epi64x(cb[2*nd+i])));
+				}
+				v = _mm256_add_epi64(_mm256_add_epi64(b0,b1),_mm256_add_epi64(b2,carryb));
+				_mm256_storeu_si256((__m256i*)(tb+k*4),_mm256_and_si256(v,m));
+				carryb = _mm256_srli_epi64(v,26);
+			}
+			else {
+				for(i=lo;i<=hi;i++) {
+					j = k-i;
+					f0 = _mm256_add_epi64(f0,_mm256_mul_epu32(_mm256_loadu_si256((const __m256i*)(in+j*4)),_mm256_set1_epi64x(cf[i])));
+					f1 = _mm256_add_epi64(f1,_mm256_mul_epu32(_mm256_loadu_si256((const __m256i*)(s1+j*4)),_mm256_set1_epi64x(cf[nfd+i])));
+					f2 = _mm256_add_epi64(f2,_mm256_mul_epu32(_mm256_loadu_si256((const __m256i*)(s2+j*4)),_mm256_set1_epi64x(cf[2*nfd+i])));
+				}
+			}
+			v = _mm256_add_epi64(_mm256_add_epi64(f0,f1),_mm256_add_epi64(f2,carryf));
+			_mm256_storeu_si256((__m256i*)(tf+k*4),_mm256_and_si256(v,m));
+			carryf = _mm256_srli_epi64(v,26);
+		}
+		_mm256_storeu_si256((__m256i*)(tf+ncol*4),_mm256_and_si256(carryf,m));
+	}
+
+	//52 bit digits - column k takes the low halves of the products i+j=k and the high halves of i+j=k-1, both from the
+	//	same coefficient digit i (the zero vectors either side of the block digits stand in for the missing halves)
+	__attribute__((target("avx512f,avx512ifma")))
+	inline void columns_avx512( const uint64_t *cd, int nd, int nfd, int ncol, const uint64_t *in, uint64_t *tb, uint64_t *tf ) {
+		const __m512i 	m = _mm512_set1_epi64((1ll<<52)-1);
+		const uint64_t 	*cb = cd, *cf = cd+3*nd;
+		const uint64_t 	*s1 = in+(nd+2)*8, *s2 = in+2*(nd+2)*8;
+		__m512i 		f0, f1, f2, g0, g1, g2, b0, b1, b2, c0, c1, c2, s, t, u, sn, tn, un, x, v, carryb, carryf;
+		int 			i, j, k, lo, hi;
+
+		carryb = carryf = _mm512_setzero_si512();
+		for(k=0;k<ncol;k++) {
+			f0 = f1 = f2 = g0 = g1 = g2 = b0 = b1 = b2 = c0 = c1 = c2 = _mm512_setzero_si512();
+			lo = k<=nd?0:k-nd;
+			hi = k<nfd?k:nfd-1;
+			j = k-lo;
+			s = _mm512_loadu_si512((const void*)(in+j*8));
+			t = _mm512_loadu_si512((const void*)(s1+j*8));
+			u = _mm512_loadu_si512((const void*)(s2+j*8));
+			for(i=lo;i<=hi;i++,j--) {
+				sn = _mm512_loadu_si512((const void*)(in+(j-1)*8));
+				tn = _mm512_loadu_si512((const void*)(s1+(j-1)*8));
+				un = _mm512_loadu_si512((const void*)(s2+(j-1)*8));
+				x  = _mm512_set1_epi64(cf[i]);
+				f0 = _mm512_madd52lo_epu64(f0,s,x);  g0 = _mm512_madd52hi_epu64(g0,sn,x);
+				x  = _mm512_set1_epi64(cf[nfd+i]);
+				f1 = _mm512_madd52lo_epu64(f1,t,x);  g1 = _mm512_madd52hi_epu64(g1,tn,x);
+				x  = _mm512_set1_epi64(cf[2*nfd+i]);
+				f2 = _mm512_madd52lo_epu64(f2,u,x);  g2 = _mm512_madd52hi_epu64(g2,un,x);
+				if(k<nd) {
+					x  = _mm512_set1_epi64(cb[i]);
+					b0 = _mm512_madd52lo_epu64(b0,s,x);  c0 = _mm512_madd52hi_epu64(c0,sn,x);
+					x  = _mm512_set1_epi64(cb[nd+i]);
+					b1 = _mm512_madd52lo_epu64(b1,t,x);  c1 = _mm512_madd52hi_epu64(c1,tn,x);
+					x  = _mm512_set1_epi64(cb[2*nd+i]);
+					b2 = _mm512_madd52lo_epu64(b2,u,x);  c2 = _mm512_madd52hi_epu64(c2,un,x);
+				}
+				s = sn; t = tn; u = un;
+			}
+			if(k<nd) {
+				v = _mm512_add_epi64(_mm512_add_epi64(_mm512_add_epi64(b0,b1),_mm512_add_epi64(b2,c0)),_mm512_add_epi64(_mm512_add_epi64(c1,c2),carryb));
+				_mm512_storeu_si512((void*)(tb+k*8),_mm512_and_si512(v,m));
+				carryb = _mm512_maskz_srli_epi64(0xff,v,52);
+			}
+			v = _mm512_add_epi64(_mm512_add_epi64(_mm512_add_epi64(f0,f1),_mm512_add_epi64(f2,g0)),_mm512_add_epi64(_mm512_add_epi64(g1,g2),carryf));
+			_mm512_storeu_si512((void*)(tf+k*8),_mm512_and_si512(v,m));
+			carryf = _mm512_maskz_srli_epi64(0xff,v,52);	//maskz form - the plain one trips -Wmaybe-uninitialized in GCC 12 headers
+		}
+		_mm512_storeu_si512((void*)(tf+ncol*8),_mm512_and_si512(carryf,m));
+	}
+
+#endif
+
+}
+
+inline bool 	otkernel_supported( otisa_t isa ) 	{ return(_otkernel::supported(isa)); }
+inline otisa_t 	otkernel_best() 					{ return(_otkernel::best()); }
+
+template <ssize_t P, ssize_t G>
+struct otkernel_t {
+
+	static_assert(P>0,"error: otkernel_t pow2bits <= 0");
+	static_assert(G>=0,"error: otkernel_t sigbuffbits < 0");
+	static_assert(P+G<=32768,"error: otkernel_t digit columns would overflow their 12 spare bits");
+
+	//constants
+	constexpr static mp_size_t INLIMBS  = (P+GMP_NUMB_BITS-1)/GMP_NUMB_BITS;		//SUM/D1/D2 and B0..B2
+	constexpr static mp_size_t OUTLIMBS = (P+G+GMP_NUMB_BITS-1)/GMP_NUMB_BITS;	//responses and F0..F2
+	constexpr static mp_size_t PRODLIMBS = INLIMBS+OUTLIMBS+1;						//F products summed
+
+	otisa_t 	m_isa;
+	int 		m_lanes, m_radix, m_nd, m_nfd, m_ncol;
+	mp_limb_t 	m_b[3][INLIMBS], m_f[3][OUTLIMBS];
+	mp_limb_t 	*m_scratch;		//per block limbs
+	uint64_t 	*m_digits;		//coefficient digits, lane digits of the blocks, column results (SIMD paths)
+
+	//
+	// routines
+	//
+
+		inline void _coef( mp_limb_t *l, mp_size_t nl, const mpz_t *v, size_t bits ) {
+			mp_size_t n = (mp_size_t)mpz_size(v[0]);
+			n = n<nl?n:nl;
+			mpn_copyi( l, mpz_limbs_read(v[0]), n );
+			mpn_zero( l+n, nl-n );
+			_otkernel::mask( l, nl, bits );
+		}
+
+		//out = ( sigpad(tb mod 2^P) + (tf >> P) ) mod 2^(P+G), tb is INLIMBS and tf PRODLIMBS limbs (tb is consumed)
+		inline void _finish( mp_limb_t *out, mp_limb_t *tb, const mp_limb_t *tf, mp_limb_t *tmp ) const {
+			constexpr mp_size_t off = P/GMP_NUMB_BITS, gl = G/GMP_NUMB_BITS;
+			constexpr int 		bits = P%GMP_NUMB_BITS, gb = G%GMP_NUMB_BITS;
+			if(bits) {
+				mpn_rshift( out, tf+off, OUTLIMBS, bits );
+				out[OUTLIMBS-1] |= tf[off+OUTLIMBS]<<(GMP_NUMB_BITS-bits);
+			}
+			else mpn_copyi( out, tf+off, OUTLIMBS );
+			_otkernel::mask( tb, INLIMBS, P );
+			mpn_zero( tmp, OUTLIMBS );
+			mpn_copyi( tmp+gl, tb, INLIMBS );
+			if(gb) mpn_lshift( tmp+gl, tmp+gl, OUTLIMBS-gl, gb );
+			mpn_add_n( out, out, tmp, OUTLIMBS );
+			_otkernel::mask( out, OUTLIMBS, P+G );
+		}
+
+		//inputs are nl limbs each (zero extended or cut to INLIMBS)
+		inline void _scalar( const mp_limb_t *in0, const mp_limb_t *in1, const mp_limb_t *in2, mp_size_t nl, mp_limb_t *out ) {
+			const mp_limb_t *in[3] = { in0, in1, in2 };
+			mp_limb_t 		*s = m_scratch, *tb = s+INLIMBS, *lo = tb+INLIMBS, *tf = lo+INLIMBS, *prod = tf+PRODLIMBS, *tmp = prod+PRODLIMBS;
+			int 			x;
+			mpn_zero( tb, INLIMBS );
+			mpn_zero( tf, PRODLIMBS );
+			for(x=0;x<3;x++) {
+				mpn_copyi( s, in[x], nl );
+				mpn_zero( s+nl, INLIMBS-nl );
+				_otkernel::mask( s, INLIMBS, P );
+				_bigmath_gmp_hacks::mpn_mullo( lo, m_b[x], s, INLIMBS, tmp );
+				mpn_add_n( tb, tb, lo, INLIMBS );
+				mpn_mul( prod, m_f[x], OUTLIMBS, s, INLIMBS );
+				mpn_add( tf, tf, PRODLIMBS, prod, PRODLIMBS-1 );
+			}
+			_finish( out, tb, tf, tmp );
+		}
+
+		//one pass of up to m_lanes blocks
+		inline void _simd( const mp_limb_t *in0, const mp_limb_t *in1, const mp_limb_t *in2, mp_size_t instride, mp_size_t nl, mp_limb_t *out, mp_size_t outstride, int n ) {
+			const int 		lanes = m_lanes;
+			const mp_size_t vec = (m_nd+2)*lanes;		//SUM, D1 and D2 digit vectors with their zero pads
+			uint64_t 		*in = m_digits+3*m_nd+3*m_nfd+lanes, *tb = in-lanes+3*vec, *tf = tb+m_nd*lanes;
+			mp_limb_t 		*lb = m_scratch, *lf = lb+INLIMBS, *tmp = lf+PRODLIMBS;
+			int 			x;
+			for(x=0;x<lanes;x++) {
+				_otkernel::todigits( in+x, 		 lanes, m_nd, m_radix, in0+x*instride, x<n?nl:0, P );
+				_otkernel::todigits( in+vec+x, 	 lanes, m_nd, m_radix, in1+x*instride, x<n?nl:0, P );
+				_otkernel::todigits( in+2*vec+x, lanes, m_nd, m_radix, in2+x*instride, x<n?nl:0, P );
+			}
+			#ifndef OTKERNELNOSIMD
+			if(m_isa==OTISA_AVX512) _otkernel::columns_avx512( m_digits, m_nd, m_nfd, m_ncol, in, tb, tf );
+			else 					_otkernel::columns_avx2( m_digits, m_nd, m_nfd, m_ncol, in, tb, tf );
+			#endif
+			for(x=0;x<n;x++) {
+				_otkernel::fromdigits( lb, INLIMBS, tb+x, lanes, m_nd, m_radix );
+				_otkernel::fromdigits( lf, PRODLIMBS, tf+x, lanes, m_ncol+1, m_radix );
+				_finish( out+x*outstride, lb, lf, tmp );
+			}
+		}
+
+	//coefficients are reduced to their field (B mod 2^P, F mod 2^(P+G)), an unsupported path falls back to the default one
+	inline otkernel_t( const mpz_t *b0, const mpz_t *b1, const mpz_t *b2, const mpz_t *f0, const mpz_t *f1, const mpz_t *f2, otisa_t isa = otkernel_best() ) :
+			m_isa(otkernel_supported(isa)?isa:otkernel_best()), m_lanes(_otkernel::LANES[m_isa]), m_radix(_otkernel::RADIX[m_isa]),
+			m_nd((P+m_radix-1)/m_radix), m_nfd((P+G+m_radix-1)/m_radix), m_ncol((2*P+G+m_radix-1)/m_radix),
+			m_scratch(new mp_limb_t[3*INLIMBS+3*PRODLIMBS]), m_digits(0) {
+		const mpz_t *b[3] = { b0, b1, b2 }, *f[3] = { f0, f1, f2 };
+		int 		x;
+		for(x=0;x<3;x++) {
+			_coef( m_b[x], INLIMBS, b[x], P );
+			_coef( m_f[x], OUTLIMBS, f[x], P+G );
+		}
+		if(m_isa!=OTISA_SCALAR) {
+			m_digits = new uint64_t[3*m_nd+3*m_nfd + (3*(m_nd+2)+m_nd+m_ncol+1)*m_lanes]();		//zero pads stay zero
+			for(x=0;x<3;x++) {
+				_otkernel::todigits( m_digits+x*m_nd, 		   1, m_nd,  m_radix, m_b[x], INLIMBS,  P );
+				_otkernel::todigits( m_digits+3*m_nd+x*m_nfd, 1, m_nfd, m_radix, m_f[x], OUTLIMBS, P+G );
+			}
+		}
+	}
+	otkernel_t( const otkernel_t & ) = delete;
+	otkernel_t &operator=( const otkernel_t & ) = delete;
+	inline ~otkernel_t() {
+		delete[] m_scratch;
+		delete[] m_digits;
+	}
+
+	inline otisa_t isa() 	const { return(m_isa); }
+	inline int 	lanes() const { return(m_lanes); }
+
+	//responses for count blocks - block x reads sum/d1/d2 + x*instride and writes out + x*outstride, inputs are inlimbs
+	//	limbs each (narrower values are zero extended, only the low INLIMBS of wider ones are read)
+	inline void run( const mp_limb_t *sum, const mp_limb_t *d1, const mp_limb_t *d2, mp_limb_t *out, size_t count,
+								mp_size_t instride = INLIMBS, mp_size_t outstride = OUTLIMBS, mp_size_t inlimbs = INLIMBS ) {
+		const mp_size_t nl = inlimbs<INLIMBS?inlimbs:INLIMBS;
+		size_t x;
+		int n;
+		if(m_isa==OTISA_SCALAR) {
+			for(x=0;x<count;x++) _scalar( sum+x*instride, d1+x*instride, d2+x*instride, nl, out+x*outstride );
+			return;
+		}
+		for(x=0;x<count;x+=m_lanes) {
+			n = (count-x)<(size_t)m_lanes?(int)(count-x):m_lanes;
+			_simd( sum+x*instride, d1+x*instride, d2+x*instride, instride, nl, out+x*outstride, outstride, n );
+		}
+	}
+
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Signature polynomials of specifications/ot.spec for the waypoints of a block store - for every pindex (modulus m, x value)
+//		P.SUMPOLY = sum of (X)(SUM[i]),  P.D1POLY = sum of (X)(D1[i]),  P.D2POLY = sum of (X)(D2[i]),  X = x^(i+1) mod m
+//	over the blocks i of a waypoint (a fixed run of blocks, the last may be short). A waypoint is built in one pass over its
+//	blocks: each block is read from the store mapping once and added into all polynomials while it is in cache (X of every
+//	polynomial stepped in native words, values added by mpn_addmul_1). Sums are exact, a limb wider than the blocks. Built
+//	waypoints are cached by number for the life of the builder, waypoints are shared out over worker threads, and the
+//	polynomials come out as otpoly_t for otverifier_t.
+
+#ifndef OTPOLYS_H
+#define OTPOLYS_H
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "../util/bigmath.h"
+#include "./otstore.h"
+#include "./otverify.h"
+
+struct otpolys_t {
+
+	const otstore_t 	&m_store;
+	size_t 				m_blocks;		//blocks per waypoint
+	size_t 				m_waypoints;
+	int 				m_count;		//polynomials per waypoint
+	uint32_t 			*m_modulus;		//m and x of each pindex
+	uint32_t 			*m_x;
+	mp_size_t 			m_limbs;		//limbs per polynomial value
+	int 				m_threads;		//build threads per call (the calling thread is one of them)
+	otpoly_t 			**m_cache;		//polynomials of each waypoint (0 until built)
+	mp_limb_t 			**m_sums;		//their values
+	std::mutex 			m_lock;
+	std::condition_variable m_ready;	//a waypoint entered the cache
+	std::atomic<size_t> m_built;		//waypoints built so far
+
+	//
+	// routines
+	//
+
+		//waypoint w into polys/sums - SUM, D1 and D2 of polynomial j at sums + (3*j+k)*m_limbs
+		inline void _build( size_t w, otpoly_t *polys, mp_limb_t *sums ) const {
+			const size_t 	first = w*m_blocks, n = m_store.count()-first<m_blocks?m_store.count()-first:m_blocks;
+			const mp_size_t vl = m_store.limbs();
+			uint64_t 		*X = new uint64_t[m_count];		//x^(i+1) of every polynomial
+			const mp_limb_t *b;
+			mp_limb_t 		*acc;
+			size_t 			i;
+			int 			j, k;
+			m_store.prefetch( first, n );
+			mpn_zero( sums, 3*m_count*m_limbs );
+			for(j=0;j<m_count;j++) X[j] = 1;
+			for(i=0;i<n;i++) {
+				b = m_store.sum( first+i );
+				for(j=0,acc=sums;j<m_count;j++) {
+					X[j] = X[j]*m_x[j]%m_modulus[j];
+					for(k=0;k<3;k++,acc+=m_limbs) acc[vl] += mpn_addmul_1( acc, b+k*vl, vl, (mp_limb_t)X[j] );
+				}
+			}
+			for(j=0;j<m_count;j++) {
+				polys[j].m_modulus = m_modulus[j];
+				polys[j].m_x = m_x[j];
+				polys[j].m_sum = sums+3*j*m_limbs;
+				polys[j].m_d1 = polys[j].m_sum+m_limbs;
+				polys[j].m_d2 = polys[j].m_d1+m_limbs;
+				polys[j].m_limbs = m_limbs;
+			}
+			delete[] X;
+		}
+
+		//polynomials of waypoint w - built here unless already cached (or waited for when another thread is building them)
+		inline const otpoly_t* _fetch( size_t w ) {
+			otpoly_t 	*polys;
+			mp_limb_t 	*sums;
+			{
+				std::unique_lock<std::mutex> lock(m_lock);
+				if(m_sums[w]) {
+					m_ready.wait( lock, [&]{ return(m_cache[w]!=0); } );
+					return(m_cache[w]);
+				}
+				m_sums[w] = sums = new mp_limb_t[3*m_count*m_limbs];		//claimed - the cache entry follows once built
+			}
+			polys = new otpoly_t[m_count];
+			_build( w, polys, sums );
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_cache[w] = polys;
+			m_built++;
+			m_ready.notify_all();
+			return(polys);
+		}
+
+		inline static void _work( otpolys_t *p, const size_t *list, size_t count, std::atomic<size_t> *next ) {
+			size_t x;
+			while((x=next->fetch_add(1))<count) p->_fetch( list[x] );
+		}
+
+	//polynomials of every blocks-long waypoint of the store for count pindex values (m below 2^32)
+	inline otpolys_t( const otstore_t &store, size_t blocks, const uint32_t *modulus, const uint32_t *x, int count, int threads = 1 ) :
+			m_store(store), m_blocks(blocks<1?1:blocks), m_waypoints(0), m_count(count<0?0:count), m_modulus(0), m_x(0),
+			m_limbs(store.limbs()+1), m_threads(threads<1?1:threads), m_cache(0), m_sums(0), m_built(0) {
+		m_waypoints = (store.count()+m_blocks-1)/m_blocks;
+		m_modulus = new uint32_t[m_count];
+		m_x = new uint32_t[m_count];
+		memcpy( m_modulus, modulus, m_count*sizeof(uint32_t) );
+		memcpy( m_x, x, m_count*sizeof(uint32_t) );
+		m_cache = new otpoly_t*[m_waypoints+1]();
+		m_sums = new mp_limb_t*[m_waypoints+1]();
+	}
+	otpolys_t( const otpolys_t & ) = delete;
+	otpolys_t &operator=( const otpolys_t & ) = delete;
+	inline ~otpolys_t() {
+		size_t w;
+		for(w=0;w<m_waypoints;w++) {
+			delete[] m_cache[w];
+			delete[] m_sums[w];
+		}
+		delete[] m_cache;
+		delete[] m_sums;
+		delete[] m_modulus;
+		delete[] m_x;
+	}
+
+	inline size_t 		waypoints() const { return(m_waypoints); }
+	inline int 			count() 	const { return(m_count); }
+	inline mp_size_t 	limbs() 	const { return(m_limbs); }
+	inline size_t 		built() 	const { return(m_built); }		//waypoints computed (each exactly once)
+
+	//the count polynomials of waypoint w, built on first use (0 past the last waypoint)
+	inline const otpoly_t* polys( size_t w ) {
+		if(w>=m_waypoints) return(0);
+		return(_fetch( w ));
+	}
+
+	//builds waypoints [first, first+count) ahead of use, shared out over the build threads
+	inline void build( size_t first, size_t count ) {
+		std::atomic<size_t> next(0);
+		std::thread 		**workers;
+		size_t 				*list, n = 0, x;
+		int 				threads, y;
+		if(first>=m_waypoints) return;
+		if(count>m_waypoints-first) count = m_waypoints-first;
+		list = new size_t[count];
+		for(x=first;x<first+count;x++) {
+			std::lock_guard<std::mutex> lock(m_lock);
+			if(!m_sums[x]) list[n++] = x;
+		}
+		threads = (size_t)m_threads<n?m_threads:(int)n;
+		if(threads<=1) _work( this, list, n, &next );
+		else {
+			workers = new std::thread*[threads-1];
+			for(y=0;y<threads-1;y++) workers[y] = new std::thread( _work, this, list, n, &next );
+			_work( this, list, n, &next );
+			for(y=0;y<threads-1;y++) { workers[y]->join(); delete workers[y]; }
+			delete[] workers;
+		}
+		delete[] list;
+	}
+
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Prime sets for the "Requestor construction" section of specifications/ot.spec - genprimes(ceilbits,primebits)
+//	Every prime is the first one at or above a random primebits bit start (top bit set), and primes are taken while their
+//	product stays below 2^ceilbits, as in examples/python.v3. Candidates above a start are sieved an interval at a time
+//	against a table of small primes: the start's residues come from one division per limb sized product of small primes
+//	(batch trial division) and only sieve survivors reach mpz_probab_prime_p (BPSW and Miller-Rabin rounds). The starts
+//	of a round are drawn on the calling thread and shared out over worker threads, so a set is the same for any thread
+//	count given the same random source.
+
+#ifndef OTPRIMES_H
+#define OTPRIMES_H
+
+#include <thread>
+#include <random>
+#include "../util/bigmath.h"
+
+namespace _otprimes {
+
+	constexpr static int SMALLPRIMES = 2048;		//odd primes in the sieve table (3 .. 17881)
+	constexpr static int SIEVE 		 = 4096;		//most odd candidates per sieve interval
+	constexpr static int SCALE 		 = 2;			//interval and table primes used per bit of the candidates (prime gaps grow with
+													//	the bits, so short candidates sieve a short interval with a few primes)
+
+	//small odd primes grouped into products that fit a limb
+	struct table_t {
+		unsigned long 	m_p[SMALLPRIMES], m_inv2[SMALLPRIMES];	//prime and 2^-1 mod prime
+		unsigned long 	m_group[SMALLPRIMES];					//product of the primes in each group
+		int 			m_groupend[SMALLPRIMES+1];				//group g holds primes [m_groupend[g-1], m_groupend[g])
+		int 			m_groups;
+
+		table_t() : m_p(), m_inv2(), m_group(), m_groupend(), m_groups(0) {
+			unsigned long 	p, q, prod;
+			int 			x;
+			for(x=0,p=3;x<SMALLPRIMES;p+=2) {
+				for(q=3;q*q<=p && p%q;q+=2);
+				if(q*q<=p) continue;
+				m_p[x] = p;
+				m_inv2[x++] = (p+1)/2;
+			}
+			for(x=0,prod=1;x<SMALLPRIMES;x++) {
+				if(prod>~0UL/m_p[x]) { m_group[m_groups] = prod; m_groupend[++m_groups] = x; prod = 1; }
+				prod *= m_p[x];
+			}
+			m_group[m_groups] = prod;
+			m_groupend[++m_groups] = SMALLPRIMES;
+		}
+	};
+
+	inline const table_t& table() {
+		static const table_t t;		//built once, thread safe initialization
+		return(t);
+	}
+
+	//r = first prime >= start - c is scratch, sieve holds SIEVE bytes
+	inline void next( mpz_ptr r, mpz_srcptr start, int reps, unsigned char *sieve, mpz_ptr c ) {
+		const table_t 	&t = table();
+		const size_t 	bits = mpz_sizeinbase(start,2);
+		const int 		len = (int)(bits*SCALE<SIEVE?bits*SCALE:SIEVE), np = (int)(bits*SCALE<SMALLPRIMES?bits*SCALE:SMALLPRIMES);
+		unsigned long 	m, rq;
+		int 			g, x, j;
+		if(mpz_cmp_ui(start,t.m_p[SMALLPRIMES-1])<=0) {		//table primes would sieve themselves out
+			mpz_sub_ui( c, start, 1 );
+			mpz_nextprime( r, c );
+			return;
+		}
+		mpz_set( c, start );
+		if(mpz_even_p(c)) mpz_add_ui( c, c, 1 );
+		while(true) {
+			memset( sieve, 0, len );
+			for(g=0;g<t.m_groups && t.m_groupend[g]<np;g++) {
+				m = mpz_fdiv_ui( c, t.m_group[g] );
+				for(x=t.m_groupend[g];x<t.m_groupend[g+1];x++) {
+					rq = m%t.m_p[x];
+					for(j=(int)(((t.m_p[x]-rq)%t.m_p[x])*t.m_inv2[x]%t.m_p[x]);j<len;j+=(int)t.m_p[x]) sieve[j] = 1;	//c+2j divisible
+				}
+			}
+			for(j=0;j<len;j++) {
+				if(sieve[j]) continue;
+				mpz_add_ui( r, c, 2*(unsigned long)j );
+				if(mpz_probab_prime_p(r,reps)) return;
+			}
+			mpz_add_ui( c, c, 2*(unsigned long)len );
+		}
+	}
+
+}
+
+struct otprimes_t {
+
+	int 	m_threads;		//worker threads per round (the calling thread is one of them)
+	int 	m_reps;			//mpz_probab_prime_p rounds
+
+	//
+	// routines
+	//
+
+		//one round - r[x] = first prime >= s[x], tasks are taken in turn by every thread
+		inline static void _work( mpz_t *r, const mpz_t *s, int count, int reps, std::atomic<int> *next ) {
+			unsigned char 	*sieve = new unsigned char[_otprimes::SIEVE];
+			mpz_t 			c;
+			int 			x;
+			mpz_init( c );
+			while((x=next->fetch_add(1))<count) _otprimes::next( r[x], s[x], reps, sieve, c );
+			mpz_clear( c );
+			delete[] sieve;
+		}
+
+		inline void _round( mpz_t *r, const mpz_t *s, int count ) const {
+			std::atomic<int> 	next(0);
+			std::thread 		**workers;
+			int 				threads = m_threads<count?m_threads:count, x;
+			if(threads<=1) { _work( r, s, count, m_reps, &next ); return; }
+			workers = new std::thread*[threads-1];
+			for(x=0;x<threads-1;x++) workers[x] = new std::thread( _work, r, s, count, m_reps, &next );
+			_work( r, s, count, m_reps, &next );
+			for(x=0;x<threads-1;x++) { workers[x]->join(); delete workers[x]; }
+			delete[] workers;
+		}
+
+		//random bits-bit start with the top bit set - from the random device unless a state is given
+		inline static void _start( mpz_ptr s, size_t bits, gmp_randstate_t *rs, std::random_device &rd ) {
+			mp_limb_t 	*l;
+			mp_size_t 	n = (mp_size_t)((bits+GMP_NUMB_BITS-1)/GMP_NUMB_BITS), x;
+			if(rs) mpz_urandomb( s, rs[0], bits );
+			else {
+				l = mpz_limbs_write( s, n );
+				for(x=0;x<n;x++) l[x] = ((mp_limb_t)rd()<<32)|rd();
+				mpz_limbs_finish( s, n );
+				mpz_fdiv_r_2exp( s, s, bits );
+			}
+			mpz_setbit( s, bits-1 );
+		}
+
+	inline explicit otprimes_t( int threads = 1, int reps = 24 ) : m_threads(threads<1?1:threads), m_reps(reps) {}
+
+	//first prime >= start
+	inline void next( mpz_ptr r, mpz_srcptr start ) const {
+		unsigned char 	*sieve = new unsigned char[_otprimes::SIEVE];
+		mpz_t 			c;
+		mpz_init( c );
+		_otprimes::next( r, start, m_reps, sieve, c );
+		mpz_clear( c );
+		delete[] sieve;
+	}
+
+	//genprimes(ceilbits,primebits) - distinct primes of primebits bits while their product is below 2^ceilbits, at most max
+	//	are written to out (initialized by the caller), returns the count - rs makes the set reproducible (tests, benchmarks)
+	inline int generate( mpz_t *out, int max, size_t ceilbits, size_t primebits, gmp_randstate_t *rs = 0 ) const {
+		std::random_device 	rd;
+		mpz_t 				*r, *s, prod;
+		int 				want, alloc, count = 0, x, y;
+		bool 				full = false;
+		if(primebits<2 || max<1) return(0);
+		want = (int)(ceilbits/primebits)+1;					//enough for one round unless primes come out short
+		want = alloc = want<max+1?want:max+1;				//later rounds never want more
+		r = new mpz_t[alloc];
+		s = new mpz_t[alloc];
+		for(x=0;x<alloc;x++) { mpz_init2( r[x], primebits+GMP_NUMB_BITS ); mpz_init2( s[x], primebits+GMP_NUMB_BITS ); }
+		mpz_init_set_ui( prod, 1 );
+		while(!full && count<max) {
+			for(x=0;x<want;x++) _start( s[x], primebits, rs, rd );
+			_round( r, s, want );
+			for(x=0;x<want && !full && count<max;x++) {
+				for(y=0;y<count && mpz_cmp(out[y],r[x]);y++);
+				if(y<count) continue;							//drawn twice
+				mpz_mul( s[0], prod, r[x] );
+				if(mpz_sizeinbase(s[0],2)>ceilbits) { full = true; break; }
+				mpz_swap( prod, s[0] );
+				mpz_set( out[count++], r[x] );
+			}
+			want = (int)((ceilbits-mpz_sizeinbase(prod,2))/primebits)+1;
+			want = want<max-count+1?want:max-count+1;
+		}
+		for(x=0;x<alloc;x++) { mpz_clear( r[x] ); mpz_clear( s[x] ); }
+		mpz_clear( prod );
+		delete[] r;
+		delete[] s;
+		return(count);
+	}
+
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Prover responses for one request of specifications/ot.spec - B = ( sigpad(Bp) + Bf ) & p2sigmask for a range of blocks
+//	An engine is built once per requestor from (B0,B1,B2,F0,F1,F2): every thread gets its own otkernel_t, so the coefficients
+//	are split into digit vectors once and block scratch is reused for the life of the request. Blocks are taken BATCH at a
+//	time (a whole number of SIMD passes) by the engine threads in turn, and a store's readahead is started a round of
+//	batches ahead of the threads. Responses are OUTLIMBS limbs each, written to an array or streamed to a sink a round
+//	at a time, and the engine keeps the blocks answered and time spent so a node can watch its blocks/sec per requestor.
+
+#ifndef OTPROVER_H
+#define OTPROVER_H
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "../util/bigmath.h"
+#include "./otkernel.h"
+#include "./otstore.h"
+
+namespace _otprover {
+
+	constexpr static size_t BATCH = 64;		//blocks per batch (a multiple of every kernel path's lanes)
+	constexpr static size_t ROUND = 16;		//batches per thread between sink writes
+
+}
+
+template <ssize_t P, ssize_t G>
+struct otprover_t {
+
+	typedef otkernel_t<P,G> kernel_t;
+	typedef bool (*sink_t)( void *ctx, const uint8_t *buf, size_t n );		//false on a write error (stops the stream)
+
+	//constants
+	constexpr static mp_size_t OUTLIMBS = kernel_t::OUTLIMBS;
+
+	kernel_t 	**m_kernels;	//one per thread
+	int 		m_threads;
+	size_t 		m_blocks;		//blocks answered
+	double 		m_seconds;		//time spent answering them
+
+	//
+	// routines
+	//
+
+		//count blocks from sum/d1/d2 at stride limbs to out, batches taken in turn through next
+		struct _job_t {
+			const mp_limb_t 	*m_sum, *m_d1, *m_d2;
+			mp_size_t 			m_stride;
+			mp_size_t 			m_limbs;		//limbs per value
+			mp_limb_t 			*m_out;
+			size_t 				m_count;
+			const otstore_t 	*m_store;		//readahead source (or 0)
+			size_t 				m_first;		//first block in the store
+			size_t 				m_ahead;		//blocks of readahead
+			std::atomic<size_t> m_next;
+		};
+
+		inline static void _work( kernel_t *k, _job_t *j ) {
+			size_t b, n;
+			while((b=j->m_next.fetch_add(_otprover::BATCH))<j->m_count) {
+				n = j->m_count-b<_otprover::BATCH?j->m_count-b:_otprover::BATCH;
+				if(j->m_store && b+j->m_ahead<j->m_count) j->m_store->prefetch( j->m_first+b+j->m_ahead, _otprover::BATCH );
+				k->run( j->m_sum+b*j->m_stride, j->m_d1+b*j->m_stride, j->m_d2+b*j->m_stride, j->m_out+b*OUTLIMBS, n, j->m_stride, OUTLIMBS, j->m_limbs );
+			}
+		}
+
+		inline void _run( _job_t &j ) {
+			const auto 	start = std::chrono::steady_clock::now();
+			const size_t batches = (j.m_count+_otprover::BATCH-1)/_otprover::BATCH;
+			std::thread **workers;
+			int 		threads = (size_t)m_threads<batches?m_threads:(int)batches, x;
+			j.m_next = 0;
+			j.m_ahead = (size_t)m_threads*_otprover::BATCH;
+			if(j.m_store) j.m_store->prefetch( j.m_first, j.m_ahead );
+			if(threads<=1) _work( m_kernels[0], &j );
+			else {
+				workers = new std::thread*[threads-1];
+				for(x=0;x<threads-1;x++) workers[x] = new std::thread( _work, m_kernels[x+1], &j );
+				_work( m_kernels[0], &j );
+				for(x=0;x<threads-1;x++) { workers[x]->join(); delete workers[x]; }
+				delete[] workers;
+			}
+			m_blocks += j.m_count;
+			m_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		}
+
+		inline void _store( _job_t &j, const otstore_t &store, size_t first, size_t count, mp_limb_t *out ) {
+			j.m_sum = store.sum(first); j.m_d1 = store.d1(first); j.m_d2 = store.d2(first);
+			j.m_stride = store.stride();
+			j.m_limbs = store.limbs();
+			j.m_out = out;
+			j.m_count = count;
+			j.m_store = &store;
+			j.m_first = first;
+		}
+
+		//blocks of the store in [first, first+count) - none when its values are wider than the field
+		inline static size_t _clip( const otstore_t &store, size_t first, size_t count ) {
+			if(!store.isopen() || store.valuebits()>(size_t)P || first>=store.count()) return(0);
+			return(count<store.count()-first?count:store.count()-first);
+		}
+
+	//the request's coefficients (reduced as otkernel_t does) and the threads answering it
+	inline otprover_t( const mpz_t *b0, const mpz_t *b1, const mpz_t *b2, const mpz_t *f0, const mpz_t *f1, const mpz_t *f2,
+						int threads = 1, otisa_t isa = otkernel_best() ) :
+			m_kernels(0), m_threads(threads<1?1:threads), m_blocks(0), m_seconds(0) {
+		int x;
+		m_kernels = new kernel_t*[m_threads];
+		for(x=0;x<m_threads;x++) m_kernels[x] = new kernel_t( b0, b1, b2, f0, f1, f2, isa );
+	}
+	otprover_t( const otprover_t & ) = delete;
+	otprover_t &operator=( const otprover_t & ) = delete;
+	inline ~otprover_t() {
+		int x;
+		for(x=0;x<m_threads;x++) delete m_kernels[x];
+		delete[] m_kernels;
+	}
+
+	inline otisa_t 	isa() 		const { return(m_kernels[0]->isa()); }
+	inline size_t 	blocks() 	const { return(m_blocks); }
+	inline double 	seconds() 	const { return(m_seconds); }
+	inline double 	rate() 		const { return(m_seconds>0?(double)m_blocks/m_seconds:0); }		//blocks/sec so far
+
+	//responses for count blocks of limb arrays - block x reads sum/d1/d2 + x*stride (limbs limbs each) and writes out + x*OUTLIMBS
+	inline void run( const mp_limb_t *sum, const mp_limb_t *d1, const mp_limb_t *d2, mp_size_t stride, mp_limb_t *out, size_t count,
+						mp_size_t limbs = kernel_t::INLIMBS ) {
+		_job_t j;
+		j.m_sum = sum; j.m_d1 = d1; j.m_d2 = d2;
+		j.m_stride = stride;
+		j.m_limbs = limbs;
+		j.m_out = out;
+		j.m_count = count;
+		j.m_store = 0;
+		j.m_first = 0;
+		_run( j );
+	}
+
+	//responses for the store's blocks [first, first+count) to out, returns the blocks answered (the range is clipped to the store,
+	//	stores of narrower values than P are zero extended and stores of wider ones are refused)
+	inline size_t run( const otstore_t &store, size_t first, size_t count, mp_limb_t *out ) {
+		_job_t j;
+		count = _clip( store, first, count );
+		if(!count) return(0);
+		_store( j, store, first, count, out );
+		_run( j );
+		return(count);
+	}
+
+	//responses for the store's blocks [first, first+count) streamed to a sink in block order (little endian limbs), a round of
+	//	batches per thread at a time - returns the blocks answered or -1 when the sink fails
+	inline ssize_t stream( const otstore_t &store, size_t first, size_t count, sink_t sink, void *ctx ) {
+		const size_t 	round = (size_t)m_threads*_otprover::ROUND*_otprover::BATCH;
+		mp_limb_t 		*out;
+		_job_t 			j;
+		size_t 			done, n;
+		count = _clip( store, first, count );
+		out = new mp_limb_t[(count<round?count:round)*OUTLIMBS+1];
+		for(done=0;done<count;done+=n) {
+			n = count-done<round?count-done:round;
+			_store( j, store, first+done, n, out );
+			_run( j );
+			if(!sink(ctx,(const uint8_t*)out,n*OUTLIMBS*mathbytes_t::LIMBBYTES)) break;
+		}
+		delete[] out;
+		return(done<count?-1:(ssize_t)count);
+	}
+
+};
+
+#endif
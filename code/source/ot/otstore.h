@@ -0,0 +1,175 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Block store for immutable encoded content - the SUM/D1/D2 blocks of otencode_t on disk behind a one page header:
+//		magic "NPOTBLK1", then little endian 64 bit limb bits, range bits (the boost is 2^rangebits), value bits
+//		(rangebits+2), limbs per value and block count
+//	Blocks follow the header back to back (SUM, D1 and D2 of limbs() limbs each) so block x sits at a fixed stride from a
+//	page aligned start. An open store maps the file read-only and hands out limb pointers into the mapping, which
+//	otkernel_t and the polynomial builder read in place - nothing is copied into bank memory and the page cache holds
+//	only the blocks in use. Stores are opened for random access (braid sections) or sequential passes, and prefetch()
+//	starts readahead for the blocks of the next batch. The mapping is read as native limbs, so little endian hosts only.
+
+#ifndef OTSTORE_H
+#define OTSTORE_H
+
+#include "../util/bigmath.h"
+#include "./otencode.h"
+
+namespace _otstore {
+
+	constexpr static char 	MAGIC[8] = { 'N','P','O','T','B','L','K','1' };
+	constexpr static size_t HEADER 	 = 4096;		//header bytes (blocks start page aligned)
+
+	struct header_t {
+		char 		m_magic[8];
+		uint64_t 	m_limbbits;
+		uint64_t 	m_rangebits;
+		uint64_t 	m_valuebits;
+		uint64_t 	m_limbs;
+		uint64_t 	m_blocks;
+	};
+
+}
+
+struct otstore_t {
+
+	mathfile_t 			m_file;
+	const mp_limb_t 	*m_data;		//first block (0 when the store didn't open)
+	size_t 				m_rangebits;
+	size_t 				m_valuebits;
+	mp_size_t 			m_limbs;
+	size_t 				m_count;
+
+	//
+	// routines
+	//
+
+		inline static void _header( _otstore::header_t &h, const otencode_t &enc, size_t blocks ) {
+			memset( &h, 0, sizeof(h) );
+			memcpy( h.m_magic, _otstore::MAGIC, sizeof(h.m_magic) );
+			h.m_limbbits  = GMP_NUMB_BITS;
+			h.m_rangebits = enc.m_rangebits;
+			h.m_valuebits = enc.m_rangebits+2;
+			h.m_limbs 	  = (uint64_t)enc.limbs();
+			h.m_blocks 	  = blocks;
+		}
+
+		//page range of blocks [first, first+count) for madvise
+		inline void _advise( size_t first, size_t count, int advice ) const {
+			const size_t 	page = (size_t)sysconf(_SC_PAGESIZE);
+			size_t 			lo, hi;
+			if(!m_data || first>=m_count) return;
+			if(count>m_count-first) count = m_count-first;
+			lo = _otstore::HEADER+first*blockbytes();
+			hi = _otstore::HEADER+(first+count)*blockbytes();
+			lo -= lo%page;
+			madvise( (void*)(m_file.data()+lo), hi-lo, advice );
+		}
+
+		//the header is only written for a complete encoding - a failed store keeps a zero header and never opens
+		inline static ssize_t _write( const char *path, const otencode_t &enc, otencode_t::source_t source, void *ctx, FILE *in ) {
+			_otstore::header_t 	h;
+			FILE 				*out = fopen( path, "wb" );
+			uint8_t 			*page;
+			ssize_t 			blocks;
+			if(!out) return(-1);
+			page = new uint8_t[_otstore::HEADER]();
+			blocks = fwrite(page,1,_otstore::HEADER,out)==_otstore::HEADER?enc.run( source, ctx, _otencode::filewrite, out ):-1;
+			if(in && ferror(in)) blocks = -1;											//read error, not the end of the content
+			if(blocks>=0) {																//count known once the content ran dry
+				_header( h, enc, (size_t)blocks );
+				memcpy( page, &h, sizeof(h) );
+				if(fseek(out,0,SEEK_SET)!=0 || fwrite(page,1,_otstore::HEADER,out)!=_otstore::HEADER) blocks = -1;
+			}
+			if(fclose(out)!=0) blocks = -1;
+			delete[] page;
+			return(blocks);
+		}
+
+	//maps the store at path - isopen() is false when it is missing, short or not a store of this build's limbs
+	inline explicit otstore_t( const char *path, bool sequential = false ) :
+			m_file(path), m_data(0), m_rangebits(0), m_valuebits(0), m_limbs(0), m_count(0) {
+		_otstore::header_t h;
+		size_t 				span;
+		#if __BYTE_ORDER__!=__ORDER_LITTLE_ENDIAN__
+		return;
+		#endif
+		if(m_file.size()<_otstore::HEADER) return;
+		memcpy( &h, m_file.data(), sizeof(h) );
+		span = m_file.size()-_otstore::HEADER;
+		if(memcmp(h.m_magic,_otstore::MAGIC,sizeof(h.m_magic)) || h.m_limbbits!=GMP_NUMB_BITS) return;
+		//widths are bounded by the data behind the header (a page for an empty store) before they are trusted in any arithmetic
+		if(h.m_limbs==0 || h.m_limbs>(span>_otstore::HEADER?span:_otstore::HEADER)/(3*mathbytes_t::LIMBBYTES)) return;
+		if(h.m_rangebits>h.m_limbs*GMP_NUMB_BITS || h.m_valuebits>h.m_limbs*GMP_NUMB_BITS) return;
+		if(h.m_valuebits!=h.m_rangebits+2 || h.m_limbs!=(h.m_valuebits+GMP_NUMB_BITS-1)/GMP_NUMB_BITS) return;
+		if(h.m_blocks>span/(3*h.m_limbs*mathbytes_t::LIMBBYTES)) return;
+		m_rangebits = (size_t)h.m_rangebits;
+		m_valuebits = (size_t)h.m_valuebits;
+		m_limbs 	= (mp_size_t)h.m_limbs;
+		m_count 	= (size_t)h.m_blocks;
+		m_data 		= (const mp_limb_t*)(m_file.data()+_otstore::HEADER);
+		madvise( (void*)m_file.data(), m_file.size(), sequential?MADV_SEQUENTIAL:MADV_RANDOM );
+	}
+
+	otstore_t( const otstore_t & ) = delete;
+	otstore_t &operator=( const otstore_t & ) = delete;
+
+	inline bool 		isopen() 		const { return(m_data!=0); }
+	inline size_t 		count() 		const { return(m_count); }
+	inline size_t 		rangebits() 	const { return(m_rangebits); }
+	inline size_t 		valuebits() 	const { return(m_valuebits); }
+	inline mp_size_t 	limbs() 		const { return(m_limbs); }
+	inline mp_size_t 	stride() 		const { return(3*m_limbs); }							//limbs from one block to the next
+	inline size_t 		blockbytes() 	const { return((size_t)stride()*mathbytes_t::LIMBBYTES); }
+
+	//limbs of block x in the mapping - run(sum(x),d1(x),d2(x),out,count,stride()) streams blocks x.. through otkernel_t
+	inline const mp_limb_t* sum( size_t x ) const { return(m_data+x*stride()); }
+	inline const mp_limb_t* d1( size_t x ) 	const { return(m_data+x*stride()+m_limbs); }
+	inline const mp_limb_t* d2( size_t x ) 	const { return(m_data+x*stride()+2*m_limbs); }
+
+	//read-only mpz view of a value (0 SUM, 1 D1, 2 D2) over the mapping, valid while the store is open
+	inline mpz_srcptr value( mpz_ptr view, size_t x, int which ) const {
+		return(mpz_roinit_n( view, m_data+x*stride()+which*m_limbs, m_limbs ));
+	}
+
+	//starts readahead for blocks [first, first+count) and lets blocks fall out of the page cache once used
+	inline void prefetch( size_t first, size_t count ) const { _advise( first, count, MADV_WILLNEED ); }
+	inline void release( size_t first, size_t count ) const  { _advise( first, count, MADV_DONTNEED ); }
+
+	//encodes the source into a new store at path, returns the blocks stored or -1 on failure
+	inline static ssize_t write( const char *path, const otencode_t &enc, otencode_t::source_t source, void *ctx ) {
+		return(_write( path, enc, source, ctx, 0 ));
+	}
+
+	//content file to a store (-1 and no store when the content can't be read to its end)
+	inline static ssize_t write( const char *path, const otencode_t &enc, const char *contentpath ) {
+		FILE 	*in = fopen( contentpath, "rb" );
+		ssize_t blocks;
+		if(!in) return(-1);
+		blocks = _write( path, enc, _otencode::fileread, in, in );
+		fclose( in );
+		return(blocks);
+	}
+
+};
+
+#endif
@@ -0,0 +1,188 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Proxy checking of specifications/ot.spec for many relayed streams at once - every stream checks a few selected signature
+//	polynomials (modulus m, x value and SUMPOLY/D1POLY/D2POLY) against the responses passing through it:
+//		X 	 = (x^i) mod m											per response i (from 1)
+//		Bacc = ( Bacc + (B)(X) ) mod pow2sig						per selected polynomial
+//		Btest = ( (B0)SUMPOLY + (B1)D1POLY + (B2)D2POLY + sigunpad(( (F0)SUMPOLY + (F1)D1POLY + (F2)D2POLY ) >> pow2bits) ) mod pow2
+//		Btest =? sigunpad(Bacc)										at the end of the waypoint
+//	Accumulators of all streams sit in one array (stream major, a stream's polynomials side by side) and X is stepped in
+//	native words (m below 2^32). A response is added to every accumulator of its stream while it is in cache, by GMP's
+//	mpn_addmul_1 (the word multiply-accumulate loop) - accumulators wrap at whole limbs and are trimmed to pow2sig when
+//	checked. Challenges of a waypoint are checked in one call shared out over worker threads that reuse their scratch.
+//	Streams are independent, so responses of different streams may be added from different threads.
+
+#ifndef OTVERIFY_H
+#define OTVERIFY_H
+
+#include <thread>
+#include <atomic>
+#include "../util/bigmath.h"
+
+//one signature polynomial - X weights response i by x^i mod m, its sums of the weighted SUM/D1/D2 blocks are limbs long
+struct otpoly_t {
+	uint32_t 			m_modulus;
+	uint32_t 			m_x;
+	const mp_limb_t 	*m_sum, *m_d1, *m_d2;
+	mp_size_t 			m_limbs;
+};
+
+template <ssize_t P, ssize_t G>
+struct otverifier_t {
+
+	static_assert(P>0 && G>=0,"error: otverifier_t bit sizes");
+
+	//constants
+	constexpr static mp_size_t OUTLIMBS = (P+G+GMP_NUMB_BITS-1)/GMP_NUMB_BITS;		//responses and accumulators
+
+	mp_limb_t 			*m_acc;			//accumulators - stream s polynomial j at (s*m_polys+j)*OUTLIMBS
+	uint32_t 			*m_X;			//current weight of each accumulator
+	const otpoly_t 		**m_selected;	//polynomial of each accumulator
+	int 				m_streams;
+	int 				m_polys;		//selected polynomials per stream
+	int 				m_threads;		//challenge threads per call (the calling thread is one of them)
+
+	//
+	// routines
+	//
+
+		//challenge scratch of one thread
+		struct _scratch_t {
+			mpz_t 	m_c, m_f, m_t;
+			mpz_t 	m_sum, m_d1, m_d2, m_acc;		//views
+		};
+
+		//Btest of stream s polynomial j against its accumulator - coef holds B0, B1, B2, F0, F1, F2
+		inline bool _check( int s, int j, const mpz_t *const *coef, _scratch_t &w ) {
+			const otpoly_t 	*p = m_selected[s*m_polys+j];
+			mp_limb_t 		*acc = m_acc+((size_t)s*m_polys+j)*OUTLIMBS;
+			mpz_srcptr 		v[3];
+			int 			x;
+			v[0] = mpz_roinit_n( w.m_sum, p->m_sum, p->m_limbs );
+			v[1] = mpz_roinit_n( w.m_d1, p->m_d1, p->m_limbs );
+			v[2] = mpz_roinit_n( w.m_d2, p->m_d2, p->m_limbs );
+			mpz_set_ui( w.m_c, 0 );
+			mpz_set_ui( w.m_f, 0 );
+			for(x=0;x<3;x++) {
+				mpz_addmul( w.m_c, coef[x][0], v[x] );
+				mpz_addmul( w.m_f, coef[x+3][0], v[x] );
+			}
+			mpz_fdiv_q_2exp( w.m_f, w.m_f, P+G );				//sigunpad(BtestF >> pow2bits)
+			mpz_add( w.m_c, w.m_c, w.m_f );
+			mpz_fdiv_r_2exp( w.m_c, w.m_c, P );
+			if((P+G)%GMP_NUMB_BITS) acc[OUTLIMBS-1] &= ((mp_limb_t)1<<((P+G)%GMP_NUMB_BITS))-1;		//Bacc mod pow2sig
+			mpz_fdiv_q_2exp( w.m_t, mpz_roinit_n( w.m_acc, acc, OUTLIMBS ), G );
+			return(mpz_cmp( w.m_c, w.m_t )==0);
+		}
+
+		inline static void _work( otverifier_t *v, const int *streams, const mpz_t *const *coefs, int count, bool *ok,
+									std::atomic<int> *next, std::atomic<int> *passed ) {
+			_scratch_t 	w;
+			int 		x, j;
+			bool 		pass;
+			mpz_inits( w.m_c, w.m_f, w.m_t, NULL );
+			while((x=next->fetch_add(1))<count) {
+				for(pass=true,j=0;j<v->m_polys && pass;j++) pass = v->_check( streams[x], j, coefs+6*x, w );
+				ok[x] = pass;
+				if(pass) passed->fetch_add(1);
+			}
+			mpz_clears( w.m_c, w.m_f, w.m_t, NULL );
+		}
+
+	//streams checking polys polynomials each and the threads checking their challenges
+	inline otverifier_t( int streams, int polys, int threads = 1 ) :
+			m_acc(0), m_X(0), m_selected(0), m_streams(streams<1?1:streams), m_polys(polys<1?1:polys), m_threads(threads<1?1:threads) {
+		const size_t n = (size_t)m_streams*m_polys;
+		m_acc = new mp_limb_t[n*OUTLIMBS]();
+		m_X = new uint32_t[n]();
+		m_selected = new const otpoly_t*[n]();
+	}
+	otverifier_t( const otverifier_t & ) = delete;
+	otverifier_t &operator=( const otverifier_t & ) = delete;
+	inline ~otverifier_t() {
+		delete[] m_acc;
+		delete[] m_X;
+		delete[] m_selected;
+	}
+
+	inline int streams() 	const { return(m_streams); }
+	inline int polys() 		const { return(m_polys); }
+
+	//upstream request - stream s starts over against its selected polynomials (polys() of them, kept by the caller)
+	inline void open( int s, const otpoly_t *const *selected ) {
+		const size_t 	base = (size_t)s*m_polys;
+		int 			j;
+		mpn_zero( m_acc+base*OUTLIMBS, m_polys*OUTLIMBS );
+		for(j=0;j<m_polys;j++) {
+			m_X[base+j] = 1;
+			m_selected[base+j] = selected[j];
+		}
+	}
+
+	//next response of stream s (OUTLIMBS limbs) into each of its accumulators
+	inline void add( int s, const mp_limb_t *b ) {
+		const size_t 	base = (size_t)s*m_polys;
+		mp_limb_t 		*acc = m_acc+base*OUTLIMBS;
+		int 			j;
+		for(j=0;j<m_polys;j++,acc+=OUTLIMBS) {
+			m_X[base+j] = (uint32_t)((uint64_t)m_X[base+j]*m_selected[base+j]->m_x%m_selected[base+j]->m_modulus);
+			mpn_addmul_1( acc, b, OUTLIMBS, m_X[base+j] );
+		}
+	}
+
+	//count responses of stream s in order, response x at b + x*stride
+	inline void addall( int s, const mp_limb_t *b, size_t count, mp_size_t stride = OUTLIMBS ) {
+		size_t x;
+		for(x=0;x<count;x++) add( s, b+x*stride );
+	}
+
+	//accumulator of stream s polynomial j (limbs above pow2sig are trimmed when checked)
+	inline const mp_limb_t* accumulator( int s, int j ) const { return(m_acc+((size_t)s*m_polys+j)*OUTLIMBS); }
+
+	//end of waypoint challenge of stream s against its requestor's B0, B1, B2, F0, F1, F2 - true when every polynomial holds
+	inline bool check( int s, const mpz_t *b0, const mpz_t *b1, const mpz_t *b2, const mpz_t *f0, const mpz_t *f1, const mpz_t *f2 ) {
+		const mpz_t *coef[6] = { b0, b1, b2, f0, f1, f2 };
+		bool 		ok;
+		checkall( &s, coef, 1, &ok );
+		return(ok);
+	}
+
+	//count challenges at once - challenge x checks streams[x] against coefs[6*x .. 6*x+5], ok[x] takes its result,
+	//	returns the challenges that passed
+	inline int checkall( const int *streams, const mpz_t *const *coefs, int count, bool *ok ) {
+		std::atomic<int> 	next(0), passed(0);
+		std::thread 		**workers;
+		int 				threads = m_threads<count?m_threads:count, x;
+		if(threads<=1) _work( this, streams, coefs, count, ok, &next, &passed );
+		else {
+			workers = new std::thread*[threads-1];
+			for(x=0;x<threads-1;x++) workers[x] = new std::thread( _work, this, streams, coefs, count, ok, &next, &passed );
+			_work( this, streams, coefs, count, ok, &next, &passed );
+			for(x=0;x<threads-1;x++) { workers[x]->join(); delete workers[x]; }
+			delete[] workers;
+		}
+		return(passed);
+	}
+
+};
+
+#endif
@@ -20,9 +20,56 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 */
 
 #include <cassert>
+#include <thread>
+#include <utility>
 
 namespace testunits {
 
+	//pool misses and hits of a thread's live paging block, over every size class or only tier
+	void _pooltotals( __int64_t &misses, __int64_t &hits, size_t thread = mathstats_t::g_threadid, int tier = -1 ) {
+		mathstats_t::snap_t snaps[64];
+		size_t n = mathstats_t::snapshot(snaps,64), x;
+		int t;
+		misses = hits = 0;
+		for(x=0;x<n && x<64;x++) {
+			if(snaps[x].m_thread!=thread || strcmp(snaps[x].m_label,"paging")!=0) continue;
+			for(t=0;t<BIGMATHPOOLTIERS;t++) {
+				if(tier>=0 && t!=tier) continue;
+				misses += snaps[x].m_tiermisses[t];
+				hits += snaps[x].m_tierhits[t];
+			}
+		}
+	}
+
+	#ifndef BIGMATHNOREMOTEFREE
+	//releases count bank entries from a foreign thread (lands them on their owner's remote free queue)
+	template <typename BANK, typename ENTRY>
+	void _remotereleaser( ENTRY **entries, int count ) {
+		int x;
+		for(x=0;x<count;x++) BANK::freenode(entries[x]);
+	}
+	#endif
+
+	//heap traffic on a short-lived thread (its stats block retires when the thread exits)
+	void _statsworker() {
+		mpz_t raw;
+		biguint2048_t v(7);
+		mpz_init2(raw,BIGMATHPOOLMIN*16);
+		mpz_clear(raw);
+		v *= v;
+	}
+
+	//exited-thread totals of a counter for a type and size
+	__int64_t _retiredcount( const char *label, ssize_t bits, int c ) {
+		mathstats_t::snap_t snaps[256];
+		size_t n = mathstats_t::snapshot(snaps,256), x;
+		__int64_t r = 0;
+		for(x=0;x<n && x<256;x++) {
+			if(snaps[x].m_thread==0 && snaps[x].m_bits==bits && strcmp(snaps[x].m_label,label)==0) r += snaps[x].m_c[c];
+		}
+		return(r);
+	}
+
 	void testbigmath() {
 
 		//basic big uint test
@@ -49,6 +96,703 @@ namespace testunits {
 
 		//...others...
 
+		#ifndef BIGMATHNOREMOTEFREE
+		//cross-thread release of bank entries lands on the owning bank's remote free queue
+		{
+			typedef mathbankaccess_t<mpz_t,2048,biguint_t<2048>>::bank_t bank_t;
+			typedef mathbankaccess_t<mpz_t,2048,biguint_t<2048>>::bankentry_t bankentry_t;
+			constexpr static int COUNT = BIGMATHBANKSIZE*2;
+			static bankentry_t *entries[COUNT];
+			int x;
+
+			for(x=0;x<COUNT;x++) entries[x] = bank_t::allocnode();
+			std::thread releaser( _remotereleaser<bank_t,bankentry_t>, entries, COUNT );
+			releaser.join();
+			assert(bank_t::g_remotepending.load()==COUNT);
+			for(x=0;x<COUNT;x++) assert(entries[x]->m_bank->m_remotefree.load()!=0);
+
+			bank_t::_drainremoteall();
+			assert(bank_t::g_remotepending.load()==0);
+		}
+
+		//modular numbers handed to another stage are released there while the owner keeps copying numbers on the modulus,
+		//	and the last release on the foreign thread hands the modulus entry back to its owner
+		{
+			typedef mathbankaccess_t<mpz_t,2048,biguint_t<2048>>::bank_t bank_t;
+			constexpr static int COUNT = 200;
+			static bigmod2048_t *handed[COUNT];
+			biguint2048_t n(1);
+			bigmod2048_t *last;
+			int x;
+			n <<= 1900; n += 4321;
+			bigmod2048_t m(3,n);
+			for(x=0;x<COUNT;x++) handed[x] = new bigmod2048_t(m);
+			last = new bigmod2048_t(5,n);
+			std::thread stage( [last](){ int y; for(y=0;y<COUNT;y++) delete handed[y]; delete last; } );
+			for(x=0;x<COUNT;x++) { bigmod2048_t c(m); c *= m; }
+			stage.join();
+			assert(m.getmodentry().m_refcnt.load()==1);
+			assert(bank_t::g_remotepending.load()>0);
+			bank_t::_drainremoteall();
+			assert(bank_t::g_remotepending.load()==0);
+		}
+		#endif
+
+		#ifndef BIGMATHNOARENA
+		//banks are carved from the thread's arena for their type and recycled there
+		{
+			typedef mathbankaccess_t<mpz_t,8192,biguint_t<8192>> access_t;
+			constexpr static int COUNT = BIGMATHBANKSIZE*3;
+			static access_t::bankentry_t *entries[COUNT];
+			_UNUSED_ __int64_t maps[2];
+			int x, pass;
+			for(pass=0;pass<2;pass++) {
+				for(x=0;x<COUNT;x++) entries[x] = access_t::bank_t::allocnode();
+				maps[pass] = access_t::g_preloader.m_stats.m_c[mathstats_t::ARENAMAP].load();
+				for(x=0;x<COUNT;x++) access_t::bank_t::freenode(entries[x]);
+			}
+			assert(maps[0]>0);
+			assert(maps[1]==maps[0]);							//second pass reused released bank slots
+			assert(access_t::bank_t::g_arena.m_regions!=0);
+		}
+		#endif
+
+		//empty banks are retained across oscillating number counts and released deterministically by trim
+		{
+			typedef mathbankaccess_t<mpz_t,4096,biguint_t<4096>> access_t;
+			constexpr static int COUNT = BIGMATHBANKSIZE;
+			static access_t::bankentry_t *entries[COUNT];
+			_UNUSED_ __int64_t creates[4], deletes;
+			int x, pass;
+			mathpaging_t::trim();
+			for(pass=0;pass<4;pass++) {
+				for(x=0;x<COUNT;x++) entries[x] = access_t::bank_t::allocnode();
+				for(x=0;x<COUNT;x++) access_t::bank_t::freenode(entries[x]);
+				creates[pass] = access_t::g_preloader.m_stats.m_c[mathstats_t::BANKNEW].load();
+			}
+			#if BIGMATHBANKKEEP>0
+			assert(creates[3]==creates[1]);						//later swings reuse the retained bank
+			#endif
+			deletes = access_t::g_preloader.m_stats.m_c[mathstats_t::BANKDELETE].load();
+			mathpaging_t::trim();
+			assert(access_t::bank_t::g_emptycount==0);
+			assert(access_t::bank_t::g_base.first()==0);			//cache flushed, no numbers of this type alive
+			assert(access_t::g_preloader.m_stats.m_c[mathstats_t::BANKDELETE].load()>deletes);
+		}
+
+		//memory outgrowing the bank is served from the pooled tiers and recycled there
+		{
+			__int64_t misses[3], hits[3];
+			mpz_t raw;
+			int x;
+			for(x=0;x<3;x++) {
+				_pooltotals(misses[x],hits[x]);
+				if(x==2) break;
+				mpz_init2(raw,4096*8);
+				mpz_realloc2(raw,8192*8);							//moves up a tier
+				mpz_clear(raw);
+			}
+			assert(misses[1]>misses[0]);						//first pass touched the heap
+			assert(misses[2]==misses[1]);						//second pass was recycled
+			assert(hits[2]>=hits[1]+2);
+		}
+
+		//per tier pool counters are published with the thread's stats block - readable from another thread
+		{
+			const size_t tier = mathpaging_t::__pool_tier(8192);
+			_UNUSED_ const size_t self = mathstats_t::g_threadid;
+			__int64_t misses[2], hits[2], seen[2];
+			_UNUSED_ mathstats_t::snap_t paging;
+			mpz_t raw;
+			int x;
+			for(x=0;x<2;x++) {
+				_pooltotals(misses[x],hits[x],self,tier);
+				if(x==1) break;
+				mpz_init2(raw,4096*8);
+				mpz_realloc2(raw,8192*8);
+				mpz_clear(raw);
+			}
+			assert(misses[1]+hits[1]>misses[0]+hits[0]);		//the 8192 byte class saw the realloc
+			std::thread([&]() { _pooltotals(seen[0],seen[1],self,tier); }).join();
+			assert(seen[0]==misses[1] && seen[1]==hits[1]);
+			_pooltotals(misses[0],hits[0],self);
+			std::thread([&]() { _pooltotals(seen[0],seen[1],self); }).join();
+			assert(seen[0]==misses[0] && seen[1]==hits[0]);
+			paging = mathstats_t::aggregate("paging");
+			for(hits[0]=misses[0]=0,x=0;x<BIGMATHPOOLTIERS;x++) { hits[0] += paging.m_tierhits[x]; misses[0] += paging.m_tiermisses[x]; }
+			assert(hits[0]==paging.m_c[mathstats_t::POOLHIT] && misses[0]==paging.m_c[mathstats_t::POOLMISS]);
+		}
+
+		//allocator telemetry is queryable per thread/type and in aggregate
+		{
+			mathstats_t::snap_t snaps[64];
+			_UNUSED_ mathstats_t::snap_t mpz, paging;
+			char json[8192];
+			FILE *f;
+			_UNUSED_ size_t n = mathstats_t::snapshot(snaps,64);
+			assert(n>=2);
+			mpz = mathstats_t::aggregate("mpz");
+			assert(mpz.m_c[mathstats_t::CACHEHIT]>0);
+			assert(mpz.m_c[mathstats_t::BANKNEW]>0);
+			paging = mathstats_t::aggregate("paging");
+			assert(paging.m_c[mathstats_t::MALLOC]>0);
+			assert(paging.m_c[mathstats_t::MALLOCBYTES]>=paging.m_c[mathstats_t::MALLOC]);
+			assert(paging.m_c[mathstats_t::POOLHIT]>0);
+			assert(mathstats_t::aggregate("mpz",2048).m_c[mathstats_t::BANKNEW]>0);
+			f = fmemopen(json,sizeof(json),"w");
+			mathstats_t::dumpjson(f);
+			fclose(f);
+			assert(strncmp(json,"{\"threads\":",11)==0);
+			assert(strstr(json,"\"type\":\"paging\"")!=0);
+			assert(strstr(json,"\"tier_hits\":[")!=0 && strstr(json,"\"tier_misses\":[")!=0);
+		}
+
+		//counters of exited threads fold into one retired block per type and size - the registry doesn't grow with the threads
+		//	that came and went and filtered aggregates keep counting them
+		{
+			_UNUSED_ __int64_t frees, hits;
+			_UNUSED_ size_t blocks;
+			int x;
+			std::thread(_statsworker).join();													//retired blocks for the worker's types
+			frees = _retiredcount("paging",0,mathstats_t::FREE);
+			hits = mathstats_t::aggregate("mpz",2048).m_c[mathstats_t::CACHEHIT];
+			blocks = mathstats_t::snapshot(0,0);
+			for(x=0;x<4;x++) {
+				std::thread worker(_statsworker);
+				worker.join();
+			}
+			assert(mathstats_t::snapshot(0,0)==blocks);
+			assert(_retiredcount("paging",0,mathstats_t::FREE)>=frees+4);						//each worker's pool went back to the heap
+			assert(mathstats_t::aggregate("paging").m_c[mathstats_t::FREE]>=_retiredcount("paging",0,mathstats_t::FREE));
+			assert(mathstats_t::aggregate("mpz",2048).m_c[mathstats_t::CACHEHIT]>hits);			//worker numbers still count
+			assert(_retiredcount("mpz",2048,mathstats_t::CACHEHIT)>0);
+		}
+
+		//move construction and assignment hand over bank entries without copying (the modulus entry is shared)
+		{
+			biguint2048_t a(5), d(7);
+			_UNUSED_ mpz_t *v = a.raw();
+			biguint2048_t c(std::move(a));
+			assert(c==5);
+			d = std::move(c);
+			assert(d==5);
+			#ifndef BIGMATHNOMOVE
+			assert(d.raw()==v);
+			assert(a.raw()==0);									//moved-from is empty
+			assert(c==7);										//assignment trades values
+			a = std::move(c);
+			assert(a==7);
+			#endif
+
+			bigint2048_t i(-3), j(std::move(i));
+			assert(j==-3);
+
+			bigfrac2048_t f(-22.25), g(std::move(f));
+			assert(strcmp((const char*)g,"-89/4")==0);
+
+			bigmod2048_t m(5,11);
+			_UNUSED_ size_t refs = m.getmodentry().m_refcnt;
+			bigmod2048_t n(std::move(m));
+			assert(n.getmodentry().m_refcnt==refs+1 && &n.getmodentry()==&m.getmodentry());		//shared with the source, which stays usable
+			assert(n==5);
+			n = bigmod2048_t(4,13)*3;
+			assert(n==12 && strcmp((const char*)bigint2048_t(n.getmod()),"13")==0);
+
+			uint2048_t s1;
+			s1 = 9;
+			uint2048_t s2(std::move(s1));
+			assert(s2==9);
+		}
+
+		//moved-from numbers stay assignable - they take fresh entries on their next assignment (modular ones keep their modulus)
+		{
+			biguint2048_t a(5), b(9);
+			biguint2048_t c(std::move(a));
+			a = b;
+			assert(a==9 && c==5);
+			biguint2048_t d(std::move(a));
+			a = 3;
+			assert(a==3 && d==9);
+			biguint2048_t e(std::move(a));
+			a = b.raw();
+			assert(a==9);
+
+			bigint2048_t i(-3), j(std::move(i));
+			i = -4;
+			assert(i==-4 && j==-3);
+
+			bigfrac2048_t f(-22.25), g(std::move(f));
+			f = 0.5;
+			assert(strcmp((const char*)f,"1/2")==0);
+			bigfrac2048_t h(std::move(f));
+			f = g;
+			assert(strcmp((const char*)f,"-89/4")==0);
+
+			bigmod2048_t m(5,11);
+			bigmod2048_t n(std::move(m));
+			m = 5;
+			assert(m==5 && strcmp((const char*)bigint2048_t(m.getmod()),"11")==0);	//keeps its modulus
+			bigmod2048_t o(std::move(m));
+			m = n;
+			assert(m==5 && strcmp((const char*)bigint2048_t(m.getmod()),"11")==0);
+		}
+
+		//lazy expressions lower to fused calls and agree with the by-value operators
+		{
+			bigint2048_t a(-1234567), b(7654321), c(99), r, e;
+			bigmod2048_t m(10,97), n(20,97);
+			biguint2048_t u(5);
+			r = bigexpr(a)*b + c;
+			e = a*b+c;
+			assert(mpz_cmp(r.raw()[0],e.raw()[0])==0);
+			r = bigexpr(a)*b - c;
+			e = a*b-c;
+			assert(mpz_cmp(r.raw()[0],e.raw()[0])==0);
+			r = bigexpr(a)*b % c;
+			mpz_mul(e.raw()[0],a.raw()[0],b.raw()[0]);
+			mpz_fdiv_r(e.raw()[0],e.raw()[0],c.raw()[0]);
+			assert(mpz_cmp(r.raw()[0],e.raw()[0])==0 && r>=0);
+			r += bigexpr(b)*c;
+			r -= bigexpr(b)*-3;
+			mpz_addmul(e.raw()[0],b.raw()[0],c.raw()[0]);
+			mpz_addmul_ui(e.raw()[0],b.raw()[0],3);
+			assert(mpz_cmp(r.raw()[0],e.raw()[0])==0);
+			m += bigexpr(n)*n;									//modular destination reduces once
+			assert(m==(10+400)%97);
+			u = bigexpr(u)*m;
+			assert(u==5*((10+400)%97));
+			r += bigexpr(b)*LONG_MIN;							//most negative factor keeps its magnitude
+			r -= bigexpr(b)*LONG_MIN;
+			assert(mpz_cmp(r.raw()[0],e.raw()[0])==0);
+
+			//crt matches the direct solver
+			bigmod2048_t v[3] = { bigmod2048_t(2,3), bigmod2048_t(3,5), bigmod2048_t(2,7) };
+			bigmod2048_t::crtsolver<2048,3> solver;
+			assert(solver.crt1(v)==23);
+			assert(solver.crt2(v)==23);
+			const bigmod2048_t::crtcontext<2048,3> context(v);
+			assert(context.crt(v)==23);
+		}
+
+		//batch inversion matches per-value inverses and flags the values sharing a factor with the modulus
+		{
+			biguint2048_t n;
+			bigmod2048_t v[9], w[9];
+			const int bases[9] = { 3, 7, 11, 13, 17, 19, 23, 29, 31 };
+			_UNUSED_ bool failed[9];
+			int x;
+			n = 1; n <<= 1500; n += 1234564;									//divisible by 5 (not by the bases)
+			for(x=0;x<9;x++) {
+				v[x] = bigmod2048_t(bases[x],n); if(x) v[x].changemod(v[0].getmodentry());
+				v[x] = v[x].pow(1000+x);
+				w[x] = v[x];
+			}
+			assert(bigmod2048_t::invertall(v,9,failed)==0);
+			for(x=0;x<9;x++) assert(!failed[x] && mpz_cmp(v[x].raw()[0],w[x].inverse().raw()[0])==0);
+			v[0] = w[0]; v[1] = w[1]; v[2] = 0; v[3] = w[1]*5;
+			assert(bigmod2048_t::invertall(v,4,failed)==2);
+			assert(!failed[0] && !failed[1] && failed[2] && failed[3] && v[2]==0);
+			assert(mpz_cmp(v[3].raw()[0],(w[1]*5).raw()[0])==0);
+			assert(mpz_cmp(v[1].raw()[0],w[1].inverse().raw()[0])==0);
+			assert(bigmod2048_t::invertall(v,0)==0);
+		}
+
+		//binary export/import matches mpz_export in both byte orders, pads to width, rejects short buffers and packs packets
+		{
+			const size_t W = 1048;
+			biguint_t<8384> a, b, v[4];
+			bigmod2048_t m(1,101);
+			uint2048_t s, t;
+			_UNUSED_ uint8_t buf[W], ref[W], packet[4*W], one[1];
+			size_t n, y;
+			__int64_t misses[2], hits[2];
+			int x;
+			mpz_ui_pow_ui(a.raw()[0],3,5000);										//991 bytes - a partial top limb
+			for(x=0;x<2;x++) {
+				_UNUSED_ const int order = x?mathbytes_t::LITTLE:mathbytes_t::BIG;
+				memset(ref,0,W);
+				mpz_export(x?ref:ref+W-991,&n,x?-1:1,1,0,0,a.raw()[0]);
+				assert(n==991 && a.export_to(buf,order,W)==W && memcmp(buf,ref,W)==0);
+				assert(b.import_from(buf,order)==W && a==b.raw());
+				assert(a.export_to(buf,order)==991 && memcmp(buf,x?ref:ref+W-991,991)==0);
+				assert(b.import_from(std::span<const uint8_t>(buf,991),order)==991 && a==b.raw());
+			}
+			assert(a.export_to(buf,mathbytes_t::BIG,990)==0 && a.export_to(std::span<uint8_t>(buf,990))==0);
+			b = 0;
+			assert(b.export_to(one)==1 && one[0]==0 && b.import_from(std::span<const uint8_t>())==0 && b==0);
+
+			assert(a.export_to(buf,mathbytes_t::BIG,W)==W && m.import_from(buf)==W);	//reduced on use
+			assert(m.export_to(one)==1 && (int)one[0]==(int)(mpz_fdiv_ui(a.raw()[0],101)));
+
+			s = a.raw();															//low 2048 bits
+			assert(s.export_to(buf)==256 && b.import_from(std::span<const uint8_t>(buf,256))==256);
+			mpz_tdiv_r_2exp(a.raw()[0],a.raw()[0],2048);
+			assert(a==b.raw() && s.export_to(buf,mathbytes_t::BIG,255)==0);
+			mpz_ui_pow_ui(a.raw()[0],3,5000);
+			assert(a.export_to(buf,mathbytes_t::LITTLE,W)==W && t.import_from(buf,mathbytes_t::LITTLE)==W && t==s);
+
+			for(x=0;x<4;x++) { v[x] = a; v[x] += x; v[x] >>= 300*x; }
+			assert(mathbytes_t::exportall(packet,v,4,W)==4*W);
+			assert(mathbytes_t::exportall(std::span<uint8_t>(packet,4*W-1),v,4,W)==0);
+			for(y=0;y<4;y++) assert(b.import_from(std::span<const uint8_t>(packet+y*W,W))==W && b==v[y].raw());
+			for(x=0;x<4;x++) v[x] = 0;
+			_pooltotals(misses[0],hits[0]);
+			assert(mathbytes_t::importall(v,4,packet,W)==4*W);
+			_pooltotals(misses[1],hits[1]);
+			assert(misses[0]==misses[1] && hits[0]==hits[1]);						//limbs read straight into bank memory
+			for(x=0;x<4;x++) { b = a; b += x; b >>= 300*x; assert(v[x]==b.raw()); }
+		}
+
+		//text of any length matches mpz_get_str (decimal past one piece splits by powers of ten), base-64 matches RFC 4648
+		{
+			const char *b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			bigint_t<65536> a[4];
+			bigmod2048_t m(1,101);
+			uint2048_t s;
+			std::string t, u;
+			uint8_t bytes[8192];
+			char *ref;
+			_UNUSED_ char small[8];
+			size_t n, y, k;
+			int x, base;
+			mpz_ui_pow_ui(a[0].raw()[0],3,40000);										//19085 digits
+			mpz_ui_pow_ui(a[1].raw()[0],7,1111); mpz_neg(a[1].raw()[0],a[1].raw()[0]);
+			a[2] = 0; a[3] = 255;
+			for(x=0;x<4;x++) for(base=10;base<=16;base+=6) {
+				ref = new char[mpz_sizeinbase(a[x].raw()[0],base)+2];
+				mpz_get_str(ref,base,a[x].raw()[0]);
+				t.clear();
+				assert(a[x].write(mathtext_t::_tostring,&t,base)==strlen(ref) && t==ref);
+				delete[] ref;
+			}
+			for(x=0;x<4;x++) {
+				mpz_export(bytes,&n,1,1,0,0,a[x].raw()[0]);
+				if(!n) bytes[n++] = 0;
+				u.clear();
+				if(mpz_sgn(a[x].raw()[0])<0) u += '-';
+				for(y=0;y<n;y+=3) {
+					k = ((size_t)bytes[y]<<16)|((y+1<n?bytes[y+1]:0)<<8)|(y+2<n?bytes[y+2]:0);
+					u += b64[k>>18]; u += b64[(k>>12)&63]; u += y+1<n?b64[(k>>6)&63]:'='; u += y+2<n?b64[k&63]:'=';
+				}
+				t.clear();
+				assert(a[x].append(t,mathtext_t::B64)==u && t.size()<=mathtext_t::length(a[x].raw()[0],mathtext_t::B64));
+			}
+			assert(t=="/w==");
+			assert(mathtext_t::format(small,sizeof(small),a[3].raw()[0],mathtext_t::HEX)==2 && strcmp(small,"ff")==0);
+			assert(mathtext_t::format(small,2,a[3].raw()[0],mathtext_t::HEX)==0);
+			m = 205;																	//clean before formatting
+			s = -1;
+			t.clear();
+			m.append(t); t += ' '; s.append(t,mathtext_t::HEX);
+			assert(t.substr(0,4)=="3 ff" && t.size()==2+512);
+			t.clear();
+			assert(mathtext_t::writeall(mathtext_t::_tostring,&t,a+2,2,mathtext_t::DEC,", ")==t.size() && t=="0, 255, ");
+		}
+
+		//text parses back in every base (decimal past one piece joins by powers of ten), bulk loads from buffers and mapped files
+		{
+			const int bases[3] = { mathtext_t::DEC, mathtext_t::HEX, mathtext_t::B64 };
+			bigint_t<65536> a[3], b;
+			biguint8192_t v[6];
+			bigmod2048_t m("1000", biguint2048_t(101));
+			_UNUSED_ uint256_t s("-1");
+			std::string t;
+			char path[] = "/tmp/bigmathXXXXXX";
+			_UNUSED_ __int64_t misses[2], hits[2];
+			FILE *f;
+			int x, y;
+			mpz_ui_pow_ui(a[0].raw()[0],3,40000);
+			mpz_ui_pow_ui(a[1].raw()[0],7,1111); mpz_neg(a[1].raw()[0],a[1].raw()[0]);
+			a[2] = 65535;
+			for(x=0;x<3;x++) for(y=0;y<3;y++) {
+				t.clear();
+				a[x].append(t,bases[y]);
+				t += ",tail";
+				assert(b.parse(t.data(),t.size(),bases[y])==t.size()-5 && mpz_cmp(a[x].raw()[0],b.raw()[0])==0);
+			}
+			assert(b.parse("0x1F",4)==4 && b==31 && b.parse("-0x1f",5,mathtext_t::HEX)==5 && b==-31);
+			assert(b.parse("0x",2)==1 && b==0 && b.parse("-",1)==0 && b.parse("12",2,8)==0 && b==0);
+			assert(b.parse("AQA=",4,mathtext_t::B64)==4 && b==256 && b.parse("AQA",3,mathtext_t::B64)==3 && b==256);
+			assert(b.parse("000000000000000000000000000000000000000012",42)==42 && b==12);
+			b = -bigint2048_t("123456789012345678901234567890");
+			assert(mpz_cmp(bigint2048_t("-123456789012345678901234567890").raw()[0],b.raw()[0])==0);
+			assert(m==1000%101 && s==-1 && biguint2048_t("0xff")==255);
+
+			t = "# fixtures\n1, 0x2,3\r\n\t-4 # trailing\n5 x 6";
+			assert(mathtext_t::readall(v,6,t.data(),t.size())==5 && v[0]==1 && v[1]==2 && mpz_cmp_si(v[3].raw()[0],-4)==0 && v[4]==5);
+			t.clear();
+			for(x=0;x<6;x++) { mpz_ui_pow_ui(v[x].raw()[0],3+x,2000); v[x].append(t); t += '\n'; }
+			assert(mathtext_t::readall(v,6,t.data(),t.size())==6);
+			for(x=0;x<6;x++) v[x] = 0;
+			_pooltotals(misses[0],hits[0]);
+			assert(mathtext_t::readall(v,6,t.data(),t.size())==6);
+			_pooltotals(misses[1],hits[1]);
+			assert(misses[0]==misses[1]);									//digits read into bank memory, GMP scratch is recycled
+			for(x=0;x<6;x++) { mpz_ui_pow_ui(b.raw()[0],3+x,2000); assert(mpz_cmp(v[x].raw()[0],b.raw()[0])==0); }
+
+			x = mkstemp(path);
+			assert(x>=0);
+			close(x);
+			f = fopen(path,"w");
+			for(x=0;x<6;x++) { t.clear(); mpz_ui_pow_ui(b.raw()[0],3+x,4000); b.append(t,mathtext_t::HEX); fprintf(f,"%s\n",t.c_str()); }
+			fclose(f);
+			for(x=0;x<6;x++) v[x] = 0;
+			assert(mathtext_t::loadall(v,6,path,mathtext_t::HEX)==6);
+			for(x=0;x<6;x++) { mpz_ui_pow_ui(b.raw()[0],3+x,4000); assert(mpz_cmp(v[x].raw()[0],b.raw()[0])==0); }
+			unlink(path);
+			assert(!mathfile_t(path).isopen() && mathtext_t::loadall(v,6,path)==0);
+		}
+
+		//a CRT context agrees with the solver over big primes and is solved against from several threads at once
+		{
+			biguint8192_t p, expect;
+			bigmod2048_t v[4];
+			bigmod2048_t::crtsolver<8192,4> solver;
+			std::thread *workers[3];
+			mpz_t e;
+			int x, y;
+			p = 1; p <<= 2000;
+			for(x=0;x<4;x++) {
+				p = biguint8192_t::nextprime(p);
+				v[x].changemod(p);
+			}
+			const bigmod2048_t::crtcontext<8192,4> context(v);
+			for(y=0;y<20;y++) {
+				for(x=0;x<4;x++) { v[x] = 0x9e3779b9+y*7919+x; v[x] = v[x].pow(65537+y); }
+				expect = solver.crt1(v);
+				assert(solver.crt2(v)==expect && (y>10 || context.crt(v)==expect));
+				if(y==10) { v[3].changemod(v[1].getmod()); v[1].changemod(p); }		//solver refreshes its inverse multipliers
+			}
+			mpz_init_set(e,expect.raw()[0]);
+			for(x=0;x<3;x++) workers[x] = new std::thread( [&context,&e](){		//workers share the context as plain data
+				mpz_t r, a[4];
+				mpz_srcptr ap[4];
+				int z;
+				mpz_init(r);
+				for(z=0;z<4;z++) { mpz_init(a[z]); mpz_mod(a[z],e,context.m_mod[z]); ap[z] = a[z]; }
+				for(z=0;z<50;z++) { context.crt(r,ap); assert(mpz_cmp(r,e)==0); }
+				for(z=0;z<4;z++) mpz_clear(a[z]);
+				mpz_clear(r);
+			} );
+			for(x=0;x<3;x++) { workers[x]->join(); delete workers[x]; }
+			mpz_clear(e);
+		}
+
+		//batch CRT through the product/remainder trees agrees with the CRT context, single and multi threaded, and round trips
+		{
+			const int BLOCKS = 37;
+			biguint2048_t p;
+			biguint8192_t r[BLOCKS];
+			bigmod2048_t v[BLOCKS*5];
+			mpz_t x[BLOCKS], back[BLOCKS*5];
+			mpz_ptr xp[BLOCKS], bp[BLOCKS*5];
+			mpz_srcptr xs[BLOCKS], bs[BLOCKS*5];
+			int b, y, t;
+			p = 1; p <<= 600;
+			for(y=0;y<5;y++) {
+				p = biguint2048_t::nextprime(p);
+				v[y].changemod(p);
+				for(b=1;b<BLOCKS;b++) v[b*5+y].changemod(v[y].getmodentry());
+			}
+			const bigmod2048_t::crtcontext<8192,5> context(v);
+			const bigmod2048_t::crtbatch<8192,5> batch(v);
+			for(b=0;b<BLOCKS*5;b++) { v[b] = 0x6a09e667+b; v[b] = v[b].pow(65537+b); mpz_init(back[b]); bp[b] = back[b]; bs[b] = back[b]; }
+			for(b=0;b<BLOCKS;b++) { mpz_init(x[b]); xp[b] = x[b]; xs[b] = x[b]; }
+			for(t=1;t<=3;t+=2) {
+				batch.crt(r,v,BLOCKS,t);
+				for(b=0;b<BLOCKS;b++) assert(r[b]==context.crt(v+b*5));
+				for(b=0;b<BLOCKS;b++) mpz_set_ui(x[b],0);
+				batch.crt(xp,bs,0,t);									//empty batch
+				for(b=0;b<BLOCKS*5;b++) mpz_set(back[b],v[b].raw()[0]);
+				batch.crt(xp,bs,BLOCKS,t);
+				for(b=0;b<BLOCKS;b++) assert(mpz_cmp(x[b],r[b].raw()[0])==0);
+				for(b=0;b<BLOCKS*5;b++) mpz_set_ui(back[b],0);
+				batch.reduce(bp,xs,BLOCKS,t);							//residues back out of the answers
+				for(b=0;b<BLOCKS*5;b++) assert(mpz_cmp(back[b],v[b].raw()[0])==0);
+			}
+			for(b=0;b<BLOCKS;b++) mpz_clear(x[b]);
+			for(b=0;b<BLOCKS*5;b++) mpz_clear(back[b]);
+		}
+
+		//reductions through the modulus entry's Barrett reciprocal agree with long division (odd, even and limb-power moduli)
+		{
+			biguint2048_t n, x;
+			mpz_t e;
+			mp_limb_t before[64];
+			_UNUSED_ const mp_limb_t *limbs;
+			mp_size_t alloc;
+			int y, z, bits;
+			mpz_init(e);
+			for(y=0;y<3;y++) {
+				n = 1; n <<= (y<2?1900:1920);
+				if(y<2) n += 1234566+y;
+				bigmod2048_t m(0,n);
+				_UNUSED_ const void *mu = m.getmodentry().m_maske;
+				#ifndef BIGMATHGMPHACKSDISABLE
+				assert(mu!=0);													//built with the entry, before any reduction
+				#endif
+				limbs = m.getmodentry().m_v[0]->_mp_d;								//modulus limbs and the spare ones above them
+				alloc = m.getmodentry().m_v[0]->_mp_alloc<64?m.getmodentry().m_v[0]->_mp_alloc:64;
+				memcpy(before,limbs,alloc*sizeof(mp_limb_t));
+				for(bits=64;bits<=4096;bits+=61) {
+					for(z=-1;z<=1;z+=2) {
+						x = 7; x <<= bits; x -= 12345;
+						if(z<0) { m = x; m.neg(); mpz_neg(e,x.raw()[0]); }
+						else 	{ m = x; 		  mpz_set(e,x.raw()[0]); }
+						mpz_mod(e,e,n.raw()[0]);
+						assert(mpz_cmp(m.raw()[0],e)==0);
+					}
+				}
+				#ifndef BIGMATHGMPHACKSDISABLE
+				assert(m.getmodentry().m_maske==mu);			//reciprocal cached on the entry
+				assert((mpz_sgn(m.getmodentry().m_maske->m_v[0])==0)==(y==2));
+				#endif
+				assert(m.getmodentry().m_v[0]->_mp_d==limbs && memcmp(before,limbs,alloc*sizeof(mp_limb_t))==0);	//shared modulus only read
+				m = 5; m %= n;
+				assert(m==5);
+				{
+					bigmod2048_t a(7,n), c(a);											//threads reducing numbers on one entry only read it
+					std::thread worker( [&c](){ int z; for(z=0;z<50;z++) c *= c; } );
+					for(z=0;z<50;z++) a *= a;
+					worker.join();
+					assert(mpz_cmp(a.raw()[0],c.raw()[0])==0 && m.getmodentry().m_maske==mu);
+				}
+			}
+			mpz_clear(e);
+		}
+
+		//Montgomery form numbers agree with plain modular arithmetic and convert only at the boundaries
+		{
+			biguint2048_t p(1);
+			int x;
+			p <<= 1500;
+			p = biguint2048_t::nextprime(p);
+			bigmod2048_t a(12345,p), e(1,p);
+			bigmont2048_t ma(12345,p), me(1,p), mt;
+			for(x=0;x<40;x++) {
+				e *= a; e += x; e *= e; e -= a;
+				me *= ma; me += x; me *= me; me -= ma;
+			}
+			assert(mpz_cmp(me.raw()[0],e.raw()[0])==0);
+			assert(me.getmodentry().m_modctx.load()!=0 && me.getmodentry().m_modctx.load()->m_mont);
+			mt = me*ma + 3;
+			e = e*a + 3;
+			assert(mpz_cmp(mt.raw()[0],e.raw()[0])==0);
+			assert(mt.inverse()*mt==1);
+			assert(mpz_cmp(ma.pow(65537).raw()[0],a.pow(65537).raw()[0])==0);
+			assert(mt==mt.plain().raw() && mt!=ma);
+
+			biguint4096_t w(1);									//wide enough for the multiply based REDC
+			w <<= 4000; w += 12345;
+			bigmod4096_t wa(3,w), we(1,w);
+			bigmont4096_t mwa(3,w), mwe(1,w);
+			wa = wa.pow(1000003); mwa = mwa.pow(1000003);
+			for(x=0;x<20;x++) { we *= wa; mwe *= mwa; }
+			assert(mpz_cmp(mwe.raw()[0],we.raw()[0])==0);
+
+			bigmont2048_t q(7,100), r(q);						//even modulus falls back to plain reduction
+			q *= r; q *= r;
+			assert(q==43 && q.getmodentry().m_modctx.load()->m_mont==false);
+		}
+
+		//fixed-base tables on the modulus entry agree with mpz_powm (odd and even moduli, table growth and fallbacks)
+		{
+			biguint2048_t n, e;
+			mpz_t r;
+			int x, y;
+			mpz_init(r);
+			for(y=0;y<2;y++) {
+				n = 1; n <<= 1500; n += 1234566+y;
+				bigmod2048_t two(2,n), g(12345,two.getmodentry()), c(2,two.getmodentry()), t;
+				two.fixbase(); g.fixbase(); c.fixbase();						//equal values share one table
+				assert(two.getmodentry().m_modctx.load()->m_fixed.load()->m_next!=0 && two.getmodentry().m_modctx.load()->m_fixed.load()->m_next->m_next==0);
+				for(x=0;x<24;x++) {
+					e = 0x9e3779b9; e <<= x*83; e += x;						//past the modulus size grows the table
+					t = c.pow(e.raw());
+					mpz_powm(r,two.raw()[0],e.raw()[0],n.raw()[0]);
+					assert(mpz_cmp(t.raw()[0],r)==0);
+					t = g.pow(e.raw());
+					mpz_powm(r,g.raw()[0],e.raw()[0],n.raw()[0]);
+					assert(mpz_cmp(t.raw()[0],r)==0);
+				}
+				e = 0; assert(c.pow(e.raw())==1);
+				e = 1; assert(c.pow(e.raw())==2);
+				if(y==1) { mpz_set_si(r,-5); assert(c.pow((const mpz_t*)&r)*32==1); }				//negative exponents go to mpz_powm
+			}
+			{
+				bigmod2048_t a(5,n), b(a), ta, tb;												//two threads build the context and the table once
+				std::thread worker( [&b,&tb,&e](){ int z; b.fixbase(); for(z=0;z<20;z++) tb = b.pow(e.raw()); } );
+				a.fixbase();
+				for(x=0;x<20;x++) ta = a.pow(e.raw());
+				worker.join();
+				mpz_powm(r,a.raw()[0],e.raw()[0],n.raw()[0]);
+				assert(mpz_cmp(ta.raw()[0],r)==0 && mpz_cmp(tb.raw()[0],r)==0);
+				assert(a.getmodentry().m_modctx.load()->m_fixed.load()->m_next==0);
+			}
+			mpz_clear(r);
+		}
+
+		//multi-exponentiation over bases on one modulus entry agrees with a product of mpz_powm (mixed lengths, zeros, fallbacks)
+		{
+			biguint2048_t n, e[5];
+			bigmod2048_t g[5], p;
+			const mpz_t *ep[5];
+			mpz_t r, t;
+			int x, y, k;
+			mpz_inits(r,t,NULL);
+			for(y=0;y<2;y++) {
+				n = 1; n <<= 1900; n += 98765+y;
+				g[0] = bigmod2048_t(3,n);
+				for(x=0;x<5;x++) {
+					if(x) g[x] = bigmod2048_t(x*1000+7,g[0].getmodentry());
+					g[x] = g[x].pow(65537+x);
+					e[x] = 0x7f4a7c15+x; e[x] <<= 400*x+y*37; e[x] -= x;		//exponent lengths differ per term
+					ep[x] = e[x];
+				}
+				for(k=1;k<=5;k++) {
+					p = bigmod2048_t::powprod(g,ep,k);
+					mpz_set_ui(r,1);
+					for(x=0;x<k;x++) { mpz_powm(t,g[x].raw()[0],e[x].raw()[0],n.raw()[0]); mpz_mul(r,r,t); mpz_mod(r,r,n.raw()[0]); }
+					assert(mpz_cmp(p.raw()[0],r)==0);
+				}
+				e[1] = 0; e[3] = 1;
+				p = bigmod2048_t::powprod(g,ep,5);
+				assert(mpz_cmp(p.raw()[0],(g[0].pow(e[0])*g[2].pow(e[2])*g[3]*g[4].pow(e[4])).raw()[0])==0);
+				e[0] = 0; e[2] = 0; e[3] = 0; e[4] = 0;
+				assert(bigmod2048_t::powprod(g,ep,5)==1);
+				if(y==1) {
+					mpz_set_si(t,-3); ep[0] = (const mpz_t*)&t; e[1] = 5;		//negative exponents go to mpz_powm
+					p = bigmod2048_t::powprod(g,ep,2)*g[0].pow(3);
+					assert(mpz_cmp(p.raw()[0],g[1].pow(5).raw()[0])==0);
+				}
+			}
+			mpz_clears(r,t,NULL);
+		}
+
+		//stream numbers wrap modulo 2^S in their inline limbs and agree with mpz arithmetic reduced by 2^S
+		{
+			uint2048_t a, b(-3), c, d;
+			mpz_t ea, eb, t;
+			int x;
+			mpz_inits(ea,eb,t,NULL);
+			a = 0x1234567; a <<= 1999; a += 0x7654321;
+			mpz_set_ui(ea,0x1234567); mpz_mul_2exp(ea,ea,1999); mpz_add_ui(ea,ea,0x7654321);
+			mpz_set_si(eb,-3);
+			for(x=0;x<30;x++) {
+				a *= a; a += b; a -= x; a *= -7; b ^= a; b >>= 3;
+				mpz_mul(ea,ea,ea); mpz_add(ea,ea,eb); mpz_sub_ui(ea,ea,x); mpz_mul_si(ea,ea,-7); mpz_fdiv_r_2exp(ea,ea,2048);
+				mpz_fdiv_r_2exp(eb,eb,2048); mpz_xor(eb,eb,ea); mpz_fdiv_q_2exp(eb,eb,3);
+			}
+			a.get(t); assert(mpz_cmp(t,ea)==0);
+			b.get(t); assert(mpz_cmp(t,eb)==0);
+			c = (const mpz_t*)&ea;
+			assert(c==a && c*b==b*a && a+(-a)==0 && (a<<2048)==0 && ((a<<64)>>64)==(a&((uint2048_t(1)<<1984)-1)));
+			assert(uint2048_t(-1)>a && uint2048_t(-1)+1==0 && (uint2048_t(5)-7)==-2);
+			memcpy((void*)&d,(const void*)&a,sizeof(a));		//trivially copyable - blocks of stream numbers move as bytes
+			assert(d==a && sizeof(uint2048_t)==2048/8);
+			mpz_clears(ea,eb,t,NULL);
+		}
+
 		//fractional rounding
 		{
 			bigfrac16384_t v1;
@@ -67,8 +811,575 @@ namespace testunits {
 		
 	}
 	
+	//ot.spec prover response for one block on the general number types (reference for the OT kernels)
+	template <ssize_t P, ssize_t G>
+	void _otreference( const mpz_t **c, const mpz_t **in, mpz_ptr out ) {
+		biguint_t<2*P+G> 	bp(0), bf(0), t, p2mask(1), p2sigmask(1);
+		int 				x;
+		p2mask <<= (int)P; 			p2mask -= 1;
+		p2sigmask <<= (int)(P+G); 	p2sigmask -= 1;
+		for(x=0;x<3;x++) {
+			t = c[x]; 	t *= in[x]; bp += t;
+			t = c[x+3]; t *= in[x]; bf += t;
+		}
+		bp &= p2mask;
+		bf >>= (int)P; bf &= p2sigmask;
+		bp <<= (int)G; bp += bf; bp &= p2sigmask;	//sigpad(Bp)+Bf
+		mpz_set( out, bp.raw()[0] );
+	}
+
+	//every supported kernel path against the reference, blocks interleaved SUM/D1/D2 with junk above P
+	template <ssize_t P, ssize_t G>
+	void _testotkernel( int count ) {
+		typedef otkernel_t<P,G> kernel_t;
+		const mp_size_t IN = kernel_t::INLIMBS, OUT = kernel_t::OUTLIMBS;
+		const otisa_t 	isas[3] = { OTISA_SCALAR, OTISA_AVX2, OTISA_AVX512 };
+		gmp_randstate_t rs;
+		mpz_t 			c[6], v[3], e;
+		const mpz_t 	*cp[6], *vp[3];
+		mp_limb_t 		*in = new mp_limb_t[3*count*IN], *out = new mp_limb_t[count*OUT], *expect = new mp_limb_t[count*OUT];
+		int 			x, y;
+
+		gmp_randinit_default(rs);
+		gmp_randseed_ui(rs,12345);
+		mpz_init(e);
+		for(x=0;x<6;x++) {
+			mpz_init(c[x]);
+			if(x%3==0) 	{ mpz_set_ui(c[x],1); mpz_mul_2exp(c[x],c[x],x<3?P:P+G); mpz_sub_ui(c[x],c[x],1); }	//all ones for the widest column sums
+			else 		mpz_urandomb(c[x],rs,x<3?P:P+G);
+			cp[x] = &c[x];
+		}
+		for(y=0;y<3;y++) { mpz_init(v[y]); vp[y] = &v[y]; }
+		for(x=0;x<count;x++) {
+			for(y=0;y<3;y++) {
+				mpn_random(in+(3*x+y)*IN,IN);
+				if(x==0) memset(in+(3*x+y)*IN,0xff,IN*sizeof(mp_limb_t));				//all ones block
+				mpz_import(v[y],IN,-1,sizeof(mp_limb_t),0,0,in+(3*x+y)*IN);
+				mpz_fdiv_r_2exp(v[y],v[y],P);
+			}
+			_otreference<P,G>(cp,vp,e);
+			mpn_zero(expect+x*OUT,OUT);
+			mpn_copyi(expect+x*OUT,mpz_limbs_read(e),mpz_size(e));
+		}
+		for(y=0;y<3;y++) {
+			if(!otkernel_supported(isas[y])) continue;
+			kernel_t k(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5],isas[y]);
+			assert(k.isa()==isas[y]);
+			memset(out,0,count*OUT*sizeof(mp_limb_t));
+			k.run(in,in+IN,in+2*IN,out,count,3*IN);
+			for(x=0;x<count;x++) assert(mpn_cmp(out+x*OUT,expect+x*OUT,OUT)==0);
+		}
+
+		for(x=0;x<6;x++) mpz_clear(c[x]);
+		for(y=0;y<3;y++) mpz_clear(v[y]);
+		mpz_clear(e);
+		gmp_randclear(rs);
+		delete[] in;
+		delete[] out;
+		delete[] expect;
+	}
+
+	//memory source (short reads) and sink (fixed capacity) for the encoding pipeline
+	struct _otstream_t {
+		uint8_t *m_data;
+		size_t 	m_size, m_pos;
+	};
+	size_t _otsource( void *ctx, uint8_t *buf, size_t n ) {
+		_otstream_t *s = (_otstream_t*)ctx;
+		if(n>1000) n = 1000;
+		if(n>s->m_size-s->m_pos) n = s->m_size-s->m_pos;
+		memcpy(buf,s->m_data+s->m_pos,n);
+		s->m_pos += n;
+		return(n);
+	}
+	bool _otsink( void *ctx, const uint8_t *buf, size_t n ) {
+		_otstream_t *s = (_otstream_t*)ctx;
+		if(n>s->m_size-s->m_pos) return(false);
+		memcpy(s->m_data+s->m_pos,buf,n);
+		s->m_pos += n;
+		return(true);
+	}
+
+	void testot() {
+
+		//streaming prover kernels are bit-identical to the general number types on every supported path (tails, unaligned and spec sizes)
+		{
+			_testotkernel<1000,40>(11);
+			_testotkernel<1024,64>(5);
+			_testotkernel<8342,48>(9);
+		}
+
+		//sieved prime sets hold distinct primes of the asked size below the product ceiling, the same for any thread count
+		{
+			mpz_t a[40], b[40], prod, t;
+			gmp_randstate_t rs;
+			int x, y, na;
+			_UNUSED_ int nb, nc;
+			otprimes_t one(1), three(3);
+			mpz_inits(prod,t,NULL);
+			for(x=0;x<40;x++) { mpz_init(a[x]); mpz_init(b[x]); }
+			for(y=0;y<3;y++) {
+				mpz_set_ui(t,1); mpz_mul_2exp(t,t,100+y*300); mpz_add_ui(t,t,y?12345:1);
+				one.next(a[0],t);
+				mpz_sub_ui(t,t,1); mpz_nextprime(b[0],t);
+				assert(mpz_cmp(a[0],b[0])==0);								//first prime at or above the start
+			}
+			mpz_set_ui(t,17000); one.next(a[0],t); assert(mpz_cmp_ui(a[0],17011)==0);	//within the sieve table
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,1234);
+			na = one.generate(a,40,1024-128,128,&rs);
+			gmp_randseed_ui(rs,1234);
+			nb = three.generate(b,40,1024-128,128,&rs);
+			assert(na>=6 && na<=7 && na==nb);
+			mpz_set_ui(prod,1);
+			for(x=0;x<na;x++) {
+				assert(mpz_cmp(a[x],b[x])==0 && mpz_sizeinbase(a[x],2)==128 && mpz_probab_prime_p(a[x],30));
+				for(y=0;y<x;y++) assert(mpz_cmp(a[x],a[y])!=0);
+				mpz_mul(prod,prod,a[x]);
+			}
+			assert(mpz_sizeinbase(prod,2)<=1024-128);
+			nc = three.generate(a,3,1024-128,128);							//random device, capped count
+			assert(nc==3 && mpz_sizeinbase(a[2],2)==128);
+			assert(three.generate(a,40,100,128)==0);						//no prime fits the ceiling
+			gmp_randclear(rs);
+			for(x=0;x<40;x++) { mpz_clear(a[x]); mpz_clear(b[x]); }
+			mpz_clears(prod,t,NULL);
+		}
+
+		//immutable encoding streams the boosted SUM/D1/D2 of the spec formulas, the same for any thread count and chunking
+		{
+			const size_t 	R = otencode_t::range(8320,128), count = 23;
+			otencode_t 		one(R), three(R,3,2), wide(R,2,1000);
+			const size_t 	inb = one.inbytes(), outb = one.blockbytes(), size = count*inb-100;	//short last block
+			uint8_t 		*content = new uint8_t[count*inb](), *a = new uint8_t[count*outb], *b = new uint8_t[count*outb];
+			mp_limb_t 		*direct = new mp_limb_t[count*3*one.limbs()];
+			_otstream_t 	in = { content, size, 0 }, sa = { a, count*outb, 0 }, sb = { b, count*outb, 0 };
+			gmp_randstate_t rs;
+			mpz_t 			v[3], e, t;
+			_UNUSED_ ssize_t n;
+			size_t 			x, y;
+			assert(R==8064 && one.limbs()==127 && inb==3*1008 && outb==3*127*8);
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,4321);
+			mpz_inits(v[0],v[1],v[2],e,t,NULL);
+			for(x=0;x<size;x++) content[x] = (uint8_t)gmp_urandomb_ui(rs,8);
+			memset(content,0xff,inb);																	//all ones block
+			n = one.run(_otsource,&in,_otsink,&sa);
+			assert(n==(ssize_t)count && sa.m_pos==count*outb);
+			for(y=0;y<2;y++) {
+				in.m_pos = sb.m_pos = 0;
+				memset(b,0,count*outb);
+				n = (y?wide:three).run(_otsource,&in,_otsink,&sb);
+				assert(n==(ssize_t)count && sb.m_pos==count*outb && memcmp(a,b,count*outb)==0);
+			}
+			one.encode(direct,content,count);
+			assert(memcmp(a,direct,count*outb)==0);
+			for(x=0;x<count;x++) {
+				for(y=0;y<3;y++) mpz_import(v[y],inb/3,-1,1,0,0,content+x*inb+y*(inb/3));
+				mpz_setbit(v[0],R);																		//boosted Ti
+				mpz_add(e,v[0],v[1]); mpz_add(e,e,v[2]);
+				mpz_import(t,one.limbs(),-1,sizeof(mp_limb_t),-1,0,a+x*outb);
+				assert(mpz_cmp(t,e)==0);
+				for(y=1;y<3;y++) {
+					mpz_sub(e,v[0],v[y]);
+					mpz_import(t,one.limbs(),-1,sizeof(mp_limb_t),-1,0,a+x*outb+y*(outb/3));
+					assert(mpz_sgn(e)>0 && mpz_cmp(t,e)==0);
+				}
+			}
+			in.m_pos = 0; sb.m_pos = 0; sb.m_size = 5*outb;												//sink fills up
+			n = three.run(_otsource,&in,_otsink,&sb);
+			assert(n==-1);
+			in.m_pos = 0; sb.m_pos = 0;
+			n = one.run(_otsource,&in,_otsink,&sb);
+			assert(n==-1);
+			in.m_pos = in.m_size;																		//no content
+			n = three.run(_otsource,&in,_otsink,&sb);
+			assert(n==0);
+			mpz_clears(v[0],v[1],v[2],e,t,NULL);
+			gmp_randclear(rs);
+			delete[] content;
+			delete[] a;
+			delete[] b;
+			delete[] direct;
+		}
+
+		//block stores map encoded content with its widths and count, otkernel_t reads the blocks in place
+		{
+			typedef otkernel_t<1024,64> kernel_t;
+			char 			path[] = "/tmp/otstoreXXXXXX";
+			const size_t 	count = 37;
+			otencode_t 		enc(1000,2,4);
+			uint8_t 		*content = new uint8_t[count*enc.inbytes()];
+			mp_limb_t 		*direct = new mp_limb_t[count*3*enc.limbs()];
+			mp_limb_t 		*outa = new mp_limb_t[count*kernel_t::OUTLIMBS], *outb = new mp_limb_t[count*kernel_t::OUTLIMBS];
+			_otstream_t 	in = { content, count*enc.inbytes(), 0 };
+			gmp_randstate_t rs;
+			mpz_t 			c[6];
+			_UNUSED_ mpz_t 	view, e;
+			_UNUSED_ ssize_t n;
+			FILE 			*f;
+			size_t 			x, y;
+			int 			fd;
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,777);
+			for(x=0;x<count*enc.inbytes();x++) content[x] = (uint8_t)gmp_urandomb_ui(rs,8);
+			for(x=0;x<6;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,x<3?1024:1024+64); }
+			enc.encode(direct,content,count);
+			fd = mkstemp(path);
+			assert(fd>=0);
+			close(fd);
+			n = otstore_t::write(path,enc,_otsource,&in);
+			assert(n==(ssize_t)count);
+			{
+				otstore_t 	st(path);
+				kernel_t 	k((const mpz_t*)&c[0],(const mpz_t*)&c[1],(const mpz_t*)&c[2],(const mpz_t*)&c[3],(const mpz_t*)&c[4],(const mpz_t*)&c[5]);
+				assert(st.isopen() && st.count()==count && st.rangebits()==1000 && st.valuebits()==1002);
+				assert(st.limbs()==16 && st.stride()==48 && st.blockbytes()==enc.blockbytes());
+				assert(memcmp(st.sum(0),direct,count*enc.blockbytes())==0 && st.d2(3)==st.sum(3)+32);
+				mpz_roinit_n(e,direct+5*48+16,16);
+				assert(mpz_cmp(st.value(view,5,1),e)==0 && mpz_sizeinbase(e,2)<=1001);
+				st.prefetch(10,20);
+				st.release(0,count+5);
+				assert(memcmp(st.sum(0),direct,count*enc.blockbytes())==0);							//dropped pages come back from the file
+				k.run(st.sum(0),st.d1(0),st.d2(0),outa,count,st.stride());
+				k.run(direct,direct+16,direct+32,outb,count,48);
+				assert(mpn_cmp(outa,outb,count*kernel_t::OUTLIMBS)==0);
+			}
+			fd = truncate(path,4096+(count-1)*enc.blockbytes());
+			assert(fd==0 && !otstore_t(path).isopen());												//short of its block count
+			in.m_pos = 0;
+			n = otstore_t::write(path,enc,_otsource,&in);
+			f = fopen(path,"r+b");
+			fputc('X',f);
+			fclose(f);
+			assert(n==(ssize_t)count && !otstore_t(path).isopen());								//not a store
+			for(y=0;y<4;y++) {																		//corrupt widths and counts
+				const uint64_t 	bad[4][4] = {
+					{ ~(uint64_t)0-2, ~(uint64_t)0, 0, count },										//limbs wrap to 0
+					{ ((uint64_t)1<<60)-2, (uint64_t)1<<60, (uint64_t)1<<54, count },					//wider than the file
+					{ 1000, 1002, 0, count },
+					{ 1000, 1002, 16, ~(uint64_t)0 } };
+				in.m_pos = 0;
+				n = otstore_t::write(path,enc,_otsource,&in);
+				assert(n==(ssize_t)count && otstore_t(path).isopen());
+				f = fopen(path,"r+b");
+				fseek(f,16,SEEK_SET);
+				n = (ssize_t)fwrite(bad[y],sizeof(uint64_t),4,f);
+				fclose(f);
+				assert(n==4 && !otstore_t(path).isopen());
+			}
+			assert(enc.run("/tmp",path)==-1);													//a read error is not the end of the content
+			assert(otstore_t::write(path,enc,"/tmp")==-1 && !otstore_t(path).isopen());
+			unlink(path);
+			assert(!otstore_t(path).isopen() && otstore_t::write("/nonexistent/store",enc,_otsource,&in)==-1);
+			for(x=0;x<6;x++) mpz_clear(c[x]);
+			gmp_randclear(rs);
+			delete[] content;
+			delete[] direct;
+			delete[] outa;
+			delete[] outb;
+		}
+
+		//prover engines answer store blocks as the spec formulas do for any thread count, through arrays and sinks
+		{
+			typedef otprover_t<1024,64> prover_t;
+			const mp_size_t OUT = prover_t::OUTLIMBS;
+			char 			path[] = "/tmp/otproverXXXXXX";
+			const size_t 	count = 300;
+			otencode_t 		enc(1000);
+			uint8_t 		*content = new uint8_t[count*enc.inbytes()];
+			mp_limb_t 		*expect = new mp_limb_t[count*OUT](), *out = new mp_limb_t[count*OUT];
+			_otstream_t 	in = { content, count*enc.inbytes(), 0 }, sa = { (uint8_t*)out, count*OUT*sizeof(mp_limb_t), 0 };
+			gmp_randstate_t rs;
+			mpz_t 			c[6], v[3], e;
+			const mpz_t 	*cp[6], *vp[3];
+			_UNUSED_ ssize_t n;
+			size_t 			x, y;
+			int 			fd;
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,999);
+			for(x=0;x<count*enc.inbytes();x++) content[x] = (uint8_t)gmp_urandomb_ui(rs,8);
+			for(x=0;x<6;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,x<3?1024:1024+64); cp[x] = &c[x]; }
+			for(y=0;y<3;y++) vp[y] = &v[y];
+			mpz_init(e);
+			fd = mkstemp(path);
+			assert(fd>=0);
+			close(fd);
+			n = otstore_t::write(path,enc,_otsource,&in);
+			assert(n==(ssize_t)count);
+			{
+				otstore_t 	st(path);
+				prover_t 	one(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5]), three(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5],3);
+				for(x=0;x<count;x++) {
+					for(y=0;y<3;y++) st.value(v[y],x,(int)y);
+					_otreference<1024,64>(cp,vp,e);
+					mpn_copyi(expect+x*OUT,mpz_limbs_read(e),mpz_size(e));
+				}
+				assert(one.run(st,0,count,out)==count && mpn_cmp(out,expect,count*OUT)==0);
+				memset(out,0,count*OUT*sizeof(mp_limb_t));
+				assert(three.run(st,7,count,out)==count-7 && mpn_cmp(out,expect+7*OUT,(count-7)*OUT)==0);		//clipped to the store
+				memset(out,0,count*OUT*sizeof(mp_limb_t));
+				three.run(st.sum(0),st.d1(0),st.d2(0),st.stride(),out,count);
+				assert(mpn_cmp(out,expect,count*OUT)==0);
+				memset(out,0,count*OUT*sizeof(mp_limb_t));
+				n = three.stream(st,0,count,_otsink,&sa);
+				assert(n==(ssize_t)count && sa.m_pos==count*OUT*sizeof(mp_limb_t) && mpn_cmp(out,expect,count*OUT)==0);
+				sa.m_pos = 0; sa.m_size = 10;
+				n = one.stream(st,0,count,_otsink,&sa);
+				assert(n==-1 && one.run(st,count,5,out)==0);
+				assert(one.blocks()==2*count && three.blocks()==3*count-7 && three.isa()==otkernel_best() && one.rate()>0);
+			}
+			unlink(path);
+			for(x=0;x<6;x++) mpz_clear(c[x]);
+			mpz_clear(e);
+			gmp_randclear(rs);
+			delete[] content;
+			delete[] expect;
+			delete[] out;
+		}
+
+		//store values narrower than the field are zero extended by every kernel path, wider ones are refused
+		{
+			typedef otprover_t<1024,64> prover_t;
+			const mp_size_t OUT = prover_t::OUTLIMBS;
+			const otisa_t 	isas[3] = { OTISA_SCALAR, OTISA_AVX2, OTISA_AVX512 };
+			char 			path[] = "/tmp/otproverXXXXXX";
+			const size_t 	count = 70;
+			otencode_t 		enc(900), wide(1100);
+			uint8_t 		*content = new uint8_t[count*wide.inbytes()];
+			mp_limb_t 		*expect = new mp_limb_t[count*OUT](), *out = new mp_limb_t[count*OUT];
+			_otstream_t 	in = { content, count*enc.inbytes(), 0 };
+			gmp_randstate_t rs;
+			mpz_t 			c[6], v[3], e;
+			const mpz_t 	*cp[6], *vp[3];
+			_UNUSED_ ssize_t n;
+			size_t 			x, y;
+			int 			fd;
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,4242);
+			for(x=0;x<count*wide.inbytes();x++) content[x] = (uint8_t)gmp_urandomb_ui(rs,8);
+			for(x=0;x<6;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,x<3?1024:1024+64); cp[x] = &c[x]; }
+			for(y=0;y<3;y++) vp[y] = &v[y];
+			mpz_init(e);
+			fd = mkstemp(path);
+			assert(fd>=0);
+			close(fd);
+			n = otstore_t::write(path,enc,_otsource,&in);
+			assert(n==(ssize_t)count);
+			{
+				otstore_t 	st(path);
+				assert(st.isopen() && st.limbs()==15 && st.limbs()<prover_t::kernel_t::INLIMBS);
+				for(x=0;x<count;x++) {
+					for(y=0;y<3;y++) st.value(v[y],x,(int)y);
+					_otreference<1024,64>(cp,vp,e);
+					mpn_copyi(expect+x*OUT,mpz_limbs_read(e),mpz_size(e));
+				}
+				for(y=0;y<3;y++) {
+					if(!otkernel_supported(isas[y])) continue;
+					prover_t p(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5],2,isas[y]);
+					memset(out,0,count*OUT*sizeof(mp_limb_t));
+					assert(p.run(st,0,count,out)==count && mpn_cmp(out,expect,count*OUT)==0);
+					memset(out,0,count*OUT*sizeof(mp_limb_t));
+					p.run(st.sum(0),st.d1(0),st.d2(0),st.stride(),out,count,st.limbs());
+					assert(mpn_cmp(out,expect,count*OUT)==0);
+				}
+			}
+			in.m_pos = 0; in.m_size = count*wide.inbytes();
+			n = otstore_t::write(path,wide,_otsource,&in);
+			{
+				otstore_t 	st(path);
+				prover_t 	p(cp[0],cp[1],cp[2],cp[3],cp[4],cp[5]);
+				assert(n==(ssize_t)count && st.isopen() && st.valuebits()>1024);
+				assert(p.run(st,0,count,out)==0 && p.stream(st,0,count,_otsink,0)==0);
+			}
+			unlink(path);
+			for(x=0;x<6;x++) mpz_clear(c[x]);
+			mpz_clear(e);
+			gmp_randclear(rs);
+			delete[] content;
+			delete[] expect;
+			delete[] out;
+		}
+
+		//proxy verifiers pass streams of prover responses against their selected polynomials and catch tampering
+		{
+			typedef otprover_t<1024,64> 	prover_t;
+			typedef otverifier_t<1024,64> 	verifier_t;
+			const mp_size_t OUT = verifier_t::OUTLIMBS;
+			const int 		NP = 4, STREAMS = 5;
+			char 			path[] = "/tmp/otverifyXXXXXX";
+			const size_t 	count = 50;
+			otencode_t 		enc(1000);
+			uint8_t 		*content = new uint8_t[count*enc.inbytes()];
+			mp_limb_t 		*resp = new mp_limb_t[count*OUT], *polylimbs = new mp_limb_t[NP*3*OUT]();
+			_otstream_t 	in = { content, count*enc.inbytes(), 0 };
+			otpoly_t 		polys[NP];
+			const otpoly_t 	*sel[NP];
+			const mpz_t 	*coefs[6*STREAMS];
+			gmp_randstate_t rs;
+			mpz_t 			c[7], sums[3], v, e, t;
+			int 			streams[STREAMS], x, y, j, fd;
+			_UNUSED_ int 	passed;
+			_UNUSED_ ssize_t n;
+			bool 			ok[STREAMS];
+			unsigned long 	X;
+			size_t 			i;
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,31337);
+			for(i=0;i<count*enc.inbytes();i++) content[i] = (uint8_t)gmp_urandomb_ui(rs,8);
+			for(x=0;x<3;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,1024); }
+			for(x=3;x<6;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,64); mpz_mul_2exp(c[x],c[x],1024); }	//whole F products, so sigunpad is exact
+			mpz_init(c[6]); mpz_add_ui(c[6],c[0],1);													//a wrong B0
+			mpz_inits(sums[0],sums[1],sums[2],e,t,NULL);
+			fd = mkstemp(path);
+			assert(fd>=0);
+			close(fd);
+			n = otstore_t::write(path,enc,_otsource,&in);
+			assert(n==(ssize_t)count);
+			{
+				otstore_t 	st(path);
+				prover_t 	pr((const mpz_t*)&c[0],(const mpz_t*)&c[1],(const mpz_t*)&c[2],(const mpz_t*)&c[3],(const mpz_t*)&c[4],(const mpz_t*)&c[5]);
+				verifier_t 	vf(STREAMS,NP,3);
+				pr.run(st,0,count,resp);
+				for(j=0;j<NP;j++) {																		//ot.spec POLYS[pindex]
+					mpz_set_ui(t,(1<<23)+gmp_urandomb_ui(rs,23)); mpz_nextprime(t,t);
+					polys[j].m_modulus = (uint32_t)mpz_get_ui(t);
+					polys[j].m_x = (uint32_t)(2+gmp_urandomb_ui(rs,23)%(polys[j].m_modulus-2));
+					for(y=0;y<3;y++) mpz_set_ui(sums[y],0);
+					for(i=0,X=polys[j].m_x;i<count;i++,X=X*polys[j].m_x%polys[j].m_modulus)
+						for(y=0;y<3;y++) mpz_addmul_ui(sums[y],st.value(v,i,y),X);
+					for(y=0;y<3;y++) mpn_copyi(polylimbs+(3*j+y)*OUT,mpz_limbs_read(sums[y]),mpz_size(sums[y]));
+					polys[j].m_sum = polylimbs+3*j*OUT; polys[j].m_d1 = polys[j].m_sum+OUT; polys[j].m_d2 = polys[j].m_d1+OUT;
+					polys[j].m_limbs = OUT;
+					sel[j] = &polys[j];
+				}
+				for(x=0;x<STREAMS;x++) {
+					streams[x] = STREAMS-1-x;
+					for(y=0;y<6;y++) coefs[6*x+y] = (const mpz_t*)&c[y];
+					vf.open(x,sel);
+					if(x==1) vf.addall(x,resp,count);
+					else for(i=0;i<count;i++) {
+						if(x==3 && i==20) resp[i*OUT+1] ^= (mp_limb_t)1<<3;	//flipped above the signature padding
+						vf.add(x,resp+i*OUT);
+						if(x==3 && i==20) resp[i*OUT+1] ^= (mp_limb_t)1<<3;
+					}
+				}
+				coefs[6*(STREAMS-1-4)] = (const mpz_t*)&c[6];											//stream 4 against another request
+				passed = vf.checkall(streams,coefs,STREAMS,ok);
+				assert(passed==3 && ok[STREAMS-1-0] && ok[STREAMS-1-1] && ok[STREAMS-1-2] && !ok[STREAMS-1-3] && !ok[STREAMS-1-4]);
+				assert(vf.check(2,&c[0],&c[1],&c[2],&c[3],&c[4],&c[5]) && !vf.check(0,&c[6],&c[1],&c[2],&c[3],&c[4],&c[5]));
+				mpz_set_ui(e,0);																		//Bacc of the python sample
+				for(i=0,X=polys[1].m_x;i<count;i++,X=X*polys[1].m_x%polys[1].m_modulus) {
+					mpz_roinit_n(v,resp+i*OUT,OUT);
+					mpz_addmul_ui(e,v,X);
+				}
+				mpz_fdiv_r_2exp(e,e,1024+64);
+				assert(mpz_cmp(e,mpz_roinit_n(v,vf.accumulator(1,1),OUT))==0 && vf.streams()==STREAMS && vf.polys()==NP);
+			}
+			unlink(path);
+			for(x=0;x<7;x++) mpz_clear(c[x]);
+			mpz_clears(sums[0],sums[1],sums[2],e,t,NULL);
+			gmp_randclear(rs);
+			delete[] content;
+			delete[] resp;
+			delete[] polylimbs;
+		}
+
+		//signature polynomials of every waypoint match the python sums, are built once whatever the thread count and verify responses
+		{
+			typedef otprover_t<1024,64> 	prover_t;
+			typedef otverifier_t<1024,64> 	verifier_t;
+			const mp_size_t OUT = prover_t::OUTLIMBS;
+			const int 		NP = 12;
+			char 			path[] = "/tmp/otpolysXXXXXX";
+			const size_t 	count = 70, WP = 32;
+			otencode_t 		enc(1000);
+			uint8_t 		*content = new uint8_t[count*enc.inbytes()];
+			mp_limb_t 		*resp = new mp_limb_t[WP*OUT];
+			_otstream_t 	in = { content, count*enc.inbytes(), 0 };
+			uint32_t 		m[NP], xv[NP];
+			const otpoly_t 	*sel[NP/2];
+			gmp_randstate_t rs;
+			mpz_t 			c[6], e, t, v;
+			_UNUSED_ ssize_t n;
+			_UNUSED_ const otpoly_t *p, *q;
+			size_t 			i, w;
+			unsigned long 	X;
+			int 			x, j, fd;
+			gmp_randinit_default(rs);
+			gmp_randseed_ui(rs,4242);
+			for(i=0;i<count*enc.inbytes();i++) content[i] = (uint8_t)gmp_urandomb_ui(rs,8);
+			for(x=0;x<3;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,1024); }
+			for(x=3;x<6;x++) { mpz_init(c[x]); mpz_urandomb(c[x],rs,64); mpz_mul_2exp(c[x],c[x],1024); }	//whole F products, so sigunpad is exact
+			mpz_inits(e,t,NULL);
+			for(j=0;j<NP;j++) {
+				mpz_set_ui(t,(1<<23)+gmp_urandomb_ui(rs,23)); mpz_nextprime(t,t);
+				m[j] = (uint32_t)mpz_get_ui(t);
+				xv[j] = (uint32_t)(2+gmp_urandomb_ui(rs,23)%(m[j]-2));
+			}
+			fd = mkstemp(path);
+			assert(fd>=0);
+			close(fd);
+			n = otstore_t::write(path,enc,_otsource,&in);
+			assert(n==(ssize_t)count);
+			{
+				otstore_t 	st(path);
+				otpolys_t 	one(st,WP,m,xv,NP), three(st,WP,m,xv,NP,3);
+				prover_t 	pr((const mpz_t*)&c[0],(const mpz_t*)&c[1],(const mpz_t*)&c[2],(const mpz_t*)&c[3],(const mpz_t*)&c[4],(const mpz_t*)&c[5]);
+				verifier_t 	vf(1,NP/2);
+				assert(one.waypoints()==3 && one.count()==NP && one.limbs()==st.limbs()+1 && !one.polys(3));
+				three.build(0,10);
+				assert(three.built()==3);
+				for(w=0;w<3;w++) {
+					p = one.polys(w); q = three.polys(w);
+					for(j=0;j<NP;j++) {
+						assert(p[j].m_modulus==m[j] && p[j].m_x==xv[j] && p[j].m_limbs==one.limbs());
+						assert(mpn_cmp(p[j].m_sum,q[j].m_sum,3*one.limbs())==0);
+						for(x=0;x<3;x++) {															//P.SUMPOLY += X*SUM[i] in python
+							mpz_set_ui(e,0);
+							for(i=w*WP,X=xv[j];i<count && i<(w+1)*WP;i++,X=X*xv[j]%m[j]) mpz_addmul_ui(e,st.value(v,i,x),X);
+							assert(mpz_cmp(e,mpz_roinit_n(v,x==0?p[j].m_sum:x==1?p[j].m_d1:p[j].m_d2,one.limbs()))==0);
+						}
+					}
+				}
+				assert(one.polys(2)==p && three.polys(2)==q && one.built()==3 && three.built()==3);	//cached, not rebuilt
+				three.build(0,3);
+				assert(three.built()==3);
+				pr.run(st,WP,WP,resp);																//a proxy checks waypoint 1 with half the set
+				for(j=0;j<NP/2;j++) sel[j] = &one.polys(1)[2*j+1];
+				vf.open(0,sel);
+				vf.addall(0,resp,WP);
+				assert(vf.check(0,&c[0],&c[1],&c[2],&c[3],&c[4],&c[5]));
+				{																					//more than 256 polynomials are all built
+					const int 	BIG = 300;
+					uint32_t 	*bm = new uint32_t[BIG], *bx = new uint32_t[BIG];
+					for(j=0;j<BIG;j++) { bm[j] = m[j%NP]; bx[j] = (uint32_t)(2+(xv[j%NP]+j)%(m[j%NP]-2)); }
+					otpolys_t 	big(st,WP,bm,bx,BIG);
+					assert(big.count()==BIG);
+					p = big.polys(1);
+					for(j=BIG-2;j<BIG;j++) {
+						assert(p[j].m_modulus==bm[j] && p[j].m_x==bx[j]);
+						mpz_set_ui(e,0);
+						for(i=WP,X=bx[j];i<2*WP;i++,X=X*bx[j]%bm[j]) mpz_addmul_ui(e,st.value(v,i,0),X);
+						assert(mpz_cmp(e,mpz_roinit_n(v,p[j].m_sum,big.limbs()))==0);
+					}
+					delete[] bm;
+					delete[] bx;
+				}
+			}
+			unlink(path);
+			for(x=0;x<6;x++) mpz_clear(c[x]);
+			mpz_clears(e,t,NULL);
+			gmp_randclear(rs);
+			delete[] content;
+			delete[] resp;
+		}
+
+	}
+
 	void start() {
 		testbigmath();
+		testot();
 	}
 	
 }
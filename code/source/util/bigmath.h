@@ -21,6 +21,12 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 
 //Troubleshooting:
 //	- Any global/static big number should either be thread_local or only used by a single thread
+//	- Numbers may be released on a different thread than the one that created them (remote free), but the creating
+//	  thread must outlive them
+//	- A moved-from number holds no value until it is assigned again (a moved-from bigmod_t keeps its modulus, so m = 5
+//	  after a move still reduces by that modulus)
+//	- Empty banks are retained (BIGMATHBANKKEEP/BIGMATHBANKIDLE) - long-running threads can call mathpaging_t::trim() between
+//	  sessions to release memory held for future numbers
 //Performance upgrades:
 //	- Prefer constructor initializer lists for structure members
 //	- Avoid the use of virtual declaration of functions in structures
@@ -58,12 +64,22 @@ extern "C" {
 #define MATHCALL
 
 #include <new>
+#include <atomic>
+#include <type_traits>
+#include <mutex>
+#include <thread>
+#include <span>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <gmp.h>
 #include "linkedlist.h"
 #include "memsafety.h"
-#ifndef BIGMATHNOMEMWARN
-#include <inttypes.h>
-#endif
 
 //
 // math memory management template
@@ -75,6 +91,15 @@ extern "C" {
 //to disable gmp hacks
 //define BIGMATHGMPHACKSDISABLE
 
+//to disable releasing numbers on a thread other than their creator (saves an ownership compare per release)
+//define BIGMATHNOREMOTEFREE
+
+//to disable move construction/assignment of numbers (moves fall back to copies - for benchmarking)
+//define BIGMATHNOMOVE
+
+//to disable mmap (huge page) arenas for banks - banks then come from the general heap
+//define BIGMATHNOARENA
+
 #ifndef BIGMATHMEMSCALE	//internal memory scaling of number over its base size before causing a memory hit
 #define BIGMATHMEMSCALE 3
 #endif
@@ -92,6 +117,14 @@ extern "C" {
 #define BIGMATHBANKSIZE 100
 #endif
 
+#ifndef BIGMATHBANKKEEP	//empty banks retained per type per thread to absorb oscillating number counts (0 frees banks as soon as empty)
+#define BIGMATHBANKKEEP 1
+#endif
+
+#ifndef BIGMATHBANKIDLE	//retained empty banks are freed after this many bank allocations of their type on the thread (0 keeps them until trim), must be power of two
+#define BIGMATHBANKIDLE 4096
+#endif
+
 #ifndef BIGMATHSTRBUFFERMAX	//max output string size from math library on any single string operation
 #define BIGMATHSTRBUFFERMAX 256
 #endif
@@ -100,12 +133,32 @@ extern "C" {
 #define BIGMATHSTRQUEUEMAX 32
 #endif
 
-#ifndef BIGMATHNOMEMWARN //disable memory hit warnings
+#ifndef BIGMATHNOMEMWARN //disable configuration warnings (memory hits are counted in mathstats_t)
 #ifdef NDEBUG
 #define BIGMATHNOMEMWARN
 #endif
 #endif
 
+#ifndef BIGMATHREDCNLIMBS //modulus size in limbs from which Montgomery reduction switches to GMP's multiply based REDC (GMP hacks only)
+#define BIGMATHREDCNLIMBS 48
+#endif
+
+#ifndef BIGMATHPOOLTIERS //count of power-of-two size classes pooled per thread for numbers that outgrow their bank
+#define BIGMATHPOOLTIERS 16
+#endif
+
+#ifndef BIGMATHPOOLMIN //smallest pooled size class in bytes, must be power of two
+#define BIGMATHPOOLMIN 64
+#endif
+
+#ifndef BIGMATHPOOLDEPTH //max free blocks retained per size class per thread before returning them to the heap
+#define BIGMATHPOOLDEPTH 64
+#endif
+
+#ifndef BIGMATHARENASIZE //granularity of bank arena regions in bytes (huge page size), must be power of two
+#define BIGMATHARENASIZE (2*1024*1024)
+#endif
+
 #ifndef BIGMATHALIGNMALLOC //allow override of malloc alignment (processor-specific), must be power of two
 #define BIGMATHALIGNMALLOC 8
 #endif
@@ -159,6 +212,12 @@ namespace _bigmath_compile {
 
 static_assert(BIGMATHMODSCALE<=BIGMATHMEMSCALE,"BIGMATHMODSCALE must be <= BIGMATHMEMSCALE");
 static_assert((1<<_bigmath_compile::log2(BIGMATHALIGNMALLOC))==BIGMATHALIGNMALLOC,"BIGMATHALIGNMALLOC is not a power of two");
+static_assert((1<<_bigmath_compile::log2(BIGMATHPOOLMIN))==BIGMATHPOOLMIN,"BIGMATHPOOLMIN is not a power of two");
+static_assert(BIGMATHPOOLMIN>=sizeof(void*),"BIGMATHPOOLMIN must hold a pointer");
+static_assert(BIGMATHPOOLTIERS>0,"BIGMATHPOOLTIERS must be > 0");
+static_assert(BIGMATHBANKIDLE==0 || (1<<_bigmath_compile::log2(BIGMATHBANKIDLE))==BIGMATHBANKIDLE,"BIGMATHBANKIDLE is not a power of two");
+static_assert((1<<_bigmath_compile::log2(BIGMATHARENASIZE))==BIGMATHARENASIZE,"BIGMATHARENASIZE is not a power of two");
+static_assert(BIGMATHREDCNLIMBS>0,"BIGMATHREDCNLIMBS must be > 0");
 
 //
 // direct hacks into GMP structures to speed up certain functionality (e.g. reducing a number)
@@ -171,6 +230,17 @@ namespace _bigmath_gmp_hacks {
 	}
 	MATHCALL inline void mpz_limbs_limit ( _UNUSED_ mpz_ptr ptr, _UNUSED_ const int maxlimbs, _UNUSED_ const mpz_ptr modulus ) 	{}
 	MATHCALL inline void prefetch( _UNUSED_ void *addr )	{}
+	//rp = up/B^n mod mp up to one subtraction (up has 2n limbs and is consumed), returns the carry out of rp
+	MATHCALL inline mp_limb_t mpn_redc( mp_ptr rp, mp_ptr up, mp_srcptr mp, mp_size_t n, mp_limb_t ninv, _UNUSED_ mp_srcptr ip ) {
+		mp_size_t x;
+		for(x=0;x<n;x++) up[x] = mpn_addmul_1( up+x, mp, n, up[x]*ninv );	//zeroes limb x, its carry is added back below
+		return mpn_add_n( rp, up+n, up, n );
+	}
+	//rp = ap*bp mod B^n (tp is 2n limbs of scratch, rp must not overlap the inputs)
+	MATHCALL inline void mpn_mullo( mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n, mp_ptr tp ) {
+		mpn_mul_n( tp, ap, bp, n );
+		mpn_copyi( rp, tp, n );
+	}
 #else
 	MATHCALL inline void mpz_realloc ( mpz_ptr ptr, _UNUSED_ const mp_bitcnt_t bits, _UNUSED_ const int limbs ) { 
 		ptr->_mp_size = 0; 
@@ -185,9 +255,233 @@ namespace _bigmath_gmp_hacks {
 	MATHCALL inline void prefetch( _UNUSED_ mpz_ptr addr )	{
 		__builtin_prefetch( addr->_mp_d, 1, 3 ); //invoke with caution to performance
 	}
+	extern "C" {
+		mp_limb_t 	__gmpn_redc_1( mp_ptr rp, mp_ptr up, mp_srcptr mp, mp_size_t n, mp_limb_t ninv );
+		void 		__gmpn_redc_n( mp_ptr rp, mp_ptr up, mp_srcptr mp, mp_size_t n, mp_srcptr ip );
+	}
+	extern "C" {
+		void 		__gmpn_mullo_n( mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n );
+	}
+	//r = |x| mod n (floored for negative x) by Barrett with mu = B^2k/n of k+1 limbs, n has k limbs - mu's allocation also
+	//	holds n zero-extended to k+1 limbs right after mu's limbs (a private copy, so n itself is only read) - false when x
+	//	is outside k < limbs <= 2k (r must not alias x)
+	MATHCALL inline bool mpz_barrett( mpz_ptr r, mpz_srcptr x, mpz_srcptr n, mpz_srcptr mu ) {
+		const mp_size_t k = mpz_size(n), xn = mpz_size(x), m = xn-k+1;
+		const mp_limb_t *np, *xp;
+		mp_limb_t *rp;
+		mp_size_t i;
+		if(xn<=k || xn>2*k) return(false);
+		np = mpz_limbs_read(mu)+k+1;
+		xp = mpz_limbs_read(x);
+		rp = mpz_limbs_write( r, 2*k+2 );
+		mpn_mul( rp, mpz_limbs_read(mu), k+1, xp+k-1, m );			//quotient estimate in the top k+1 limbs
+		for(i=k+1+m;i<2*k+2;i++) rp[i] = 0;
+		__gmpn_mullo_n( rp, rp+k+1, np, k+1 );						//only the low limbs of quotient*n are needed
+		mpn_sub_n( rp, xp, rp, k+1 );								//remainder below 3n
+		while(rp[k] || mpn_cmp(rp,np,k)>=0) rp[k] -= mpn_sub_n( rp, rp, np, k );
+		mpz_limbs_finish( r, k );
+		if(mpz_sgn(x)<0 && mpz_sgn(r)!=0) mpz_sub( r, n, r );
+		return(true);
+	}
+	//rp = ap*bp mod B^n (rp must not overlap the inputs)
+	MATHCALL inline void mpn_mullo( mp_ptr rp, mp_srcptr ap, mp_srcptr bp, mp_size_t n, _UNUSED_ mp_ptr tp ) {
+		__gmpn_mullo_n( rp, ap, bp, n );
+	}
+	//GMP's internal REDC (as used by mpz_powm) - limb at a time below BIGMATHREDCNLIMBS, mullo + wrap-around multiply above
+	MATHCALL inline mp_limb_t mpn_redc( mp_ptr rp, mp_ptr up, mp_srcptr mp, mp_size_t n, mp_limb_t ninv, mp_srcptr ip ) {
+		if(n<BIGMATHREDCNLIMBS) return __gmpn_redc_1( rp, up, mp, n, ninv );
+		__gmpn_redc_n( rp, up, mp, n, ip );
+		return(0);
+	}
 #endif
 }
 
+//
+// allocator telemetry - always compiled, one writer per counter block (the owning thread) so
+//	counting is a relaxed load/store while any thread may snapshot or aggregate the registry
+//
+
+struct mathstats_t {
+
+	//counters
+	enum {
+		CACHEHIT, CACHEMISS, BANKNEW, BANKDELETE, REMOTEFREE, ARENAMAP, 	//per number type (bank) counters
+		POOLHIT, POOLMISS, MALLOC, MALLOCBYTES, REALLOC, REALLOCBYTES, FREE,	//per thread paging counters
+		COUNT
+	};
+
+	constexpr static const char *NAMES[COUNT] = {
+		"cache_hits", "cache_misses", "bank_creates", "bank_deletes", "remote_frees", "arena_maps",
+		"pool_hits", "pool_misses", "mallocs", "malloc_bytes", "reallocs", "realloc_bytes", "frees"
+	};
+
+	//point in time copy of a counter block
+	struct snap_t {
+		const char 	*m_label;
+		ssize_t 	m_bits;
+		size_t 		m_thread;	//0 for the totals folded in from exited threads (one block per type and size)
+		__int64_t 	m_c[COUNT];
+		__int64_t 	m_tierhits[BIGMATHPOOLTIERS], m_tiermisses[BIGMATHPOOLTIERS];	//POOLHIT and POOLMISS by size class
+	};
+
+	//registry of every counter block (locked only when blocks come and go or are read)
+	static std::mutex 				g_lock;
+	static linkbase<mathstats_t> 	g_live;
+	static linkbase<mathstats_t> 	g_retired;		//totals of exited threads, one block per label and bits
+	static std::atomic<size_t> 		g_threadcount;
+	static thread_local size_t 		g_threadid;
+
+	std::atomic<__int64_t> 	m_c[COUNT];
+	std::atomic<__int64_t> 	m_tierhits[BIGMATHPOOLTIERS], m_tiermisses[BIGMATHPOOLTIERS];
+	linkitem<mathstats_t> 	m_item;
+	const char 				*m_label;
+	ssize_t 				m_bits;
+	size_t 					m_thread;
+	bool 					m_enrolled;
+	bool 					m_retired;		//folded into a g_retired block - later paging events go uncounted
+
+	MATHCALL mathstats_t() : m_c(), m_tierhits(), m_tiermisses(), m_item(this), m_label(""), m_bits(0), m_thread(0), m_enrolled(false), m_retired(false) {}
+	MATHCALL explicit mathstats_t( const char *label ) :
+			m_c(), m_tierhits(), m_tiermisses(), m_item(this), m_label(label), m_bits(0), m_thread(0), m_enrolled(false), m_retired(false) {}
+	MATHCALL ~mathstats_t() { retire(); }
+
+		MATHCALL inline static void _bump( std::atomic<__int64_t> &c, __int64_t v ) {
+			c.store(c.load(std::memory_order_relaxed)+v,std::memory_order_relaxed);
+		}
+
+	MATHCALL inline void bump( int c, __int64_t v=1 ) { _bump(m_c[c],v); }
+
+	//paging events are slow paths - enroll on first use
+	MATHCALL inline void bumppaging( int c, size_t bytes=0 ) {
+		if(!m_enrolled) { if(m_retired) return; enroll("paging",0); }
+		bump(c);
+		if(bytes) bump(c+1,(__int64_t)bytes);	//byte counters follow their event counter
+	}
+
+	//pool hit or miss, also counted against its size class
+	MATHCALL inline void bumppool( int c, size_t tier ) {
+		if(!m_enrolled) { if(m_retired) return; enroll("paging",0); }
+		bump(c);
+		_bump(c==POOLHIT?m_tierhits[tier]:m_tiermisses[tier],1);
+	}
+
+	MATHCALL void enroll( const char *label, ssize_t bits ) {
+		std::lock_guard<std::mutex> lock(g_lock);
+		if(m_enrolled) return;
+		if(g_threadid==0) g_threadid = ++g_threadcount;
+		m_label 	= label;
+		m_bits 		= bits;
+		m_thread 	= g_threadid;
+		m_enrolled 	= true;
+		g_live.add(&m_item);
+	}
+
+		//exited-thread totals for a label and bits (created on first use, never released)
+		MATHCALL static mathstats_t *_retiredblock( const char *label, ssize_t bits ) {
+			mathstats_t *s;
+			for(s=g_retired.first();s;s=g_retired.after(&s->m_item)) {
+				if(s->m_bits==bits && strcmp(label,s->m_label)==0) return(s);
+			}
+			s = new mathstats_t(label);
+			s->m_bits = bits;
+			g_retired.add(&s->m_item);
+			return(s);
+		}
+
+	//fold counters into the exited-thread totals of the same type and size (registry size stays bounded by the live threads
+	//	and the instantiated types)
+	MATHCALL void retire() {
+		mathstats_t *r;
+		int x;
+		if(!m_enrolled) return;
+		std::lock_guard<std::mutex> lock(g_lock);
+		g_live.remove(&m_item);
+		m_enrolled = false;
+		m_retired = true;
+		r = _retiredblock(m_label,m_bits);
+		for(x=0;x<COUNT;x++) r->bump(x,m_c[x].load(std::memory_order_relaxed));
+		for(x=0;x<BIGMATHPOOLTIERS;x++) {
+			_bump(r->m_tierhits[x],m_tierhits[x].load(std::memory_order_relaxed));
+			_bump(r->m_tiermisses[x],m_tiermisses[x].load(std::memory_order_relaxed));
+		}
+	}
+
+		MATHCALL void _copy( snap_t &out ) const {
+			int x;
+			out.m_label  = m_label;
+			out.m_bits 	 = m_bits;
+			out.m_thread = m_thread;
+			for(x=0;x<COUNT;x++) out.m_c[x] = m_c[x].load(std::memory_order_relaxed);
+			for(x=0;x<BIGMATHPOOLTIERS;x++) {
+				out.m_tierhits[x] 	= m_tierhits[x].load(std::memory_order_relaxed);
+				out.m_tiermisses[x] = m_tiermisses[x].load(std::memory_order_relaxed);
+			}
+		}
+
+	//copies up to max blocks (live threads then the exited totals), returns count of blocks available
+	MATHCALL static size_t snapshot( snap_t *out, size_t max ) {
+		std::lock_guard<std::mutex> lock(g_lock);
+		mathstats_t *s;
+		size_t n=0;
+		for(s=g_live.first();s;s=g_live.after(&s->m_item)) 		{ if(n<max) s->_copy(out[n]); n++; }
+		for(s=g_retired.first();s;s=g_retired.after(&s->m_item)) 	{ if(n<max) s->_copy(out[n]); n++; }
+		return(n);
+	}
+
+		MATHCALL static void _sum( linkbase<mathstats_t> &list, snap_t &r, const char *label, ssize_t bits ) {
+			mathstats_t *s;
+			int x;
+			for(s=list.first();s;s=list.after(&s->m_item)) {
+				if(label && strcmp(label,s->m_label)!=0) continue;
+				if(bits && bits!=s->m_bits) continue;
+				for(x=0;x<COUNT;x++) r.m_c[x] += s->m_c[x].load(std::memory_order_relaxed);
+				for(x=0;x<BIGMATHPOOLTIERS;x++) {
+					r.m_tierhits[x] 	+= s->m_tierhits[x].load(std::memory_order_relaxed);
+					r.m_tiermisses[x] 	+= s->m_tiermisses[x].load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+	//sums all blocks matching label (0 for any) and bits (0 for any), live threads and exited ones alike
+	MATHCALL static snap_t aggregate( const char *label=0, ssize_t bits=0 ) {
+		std::lock_guard<std::mutex> lock(g_lock);
+		snap_t r = { label?label:"all", bits, 0, {}, {}, {} };
+		_sum( g_live, r, label, bits );
+		_sum( g_retired, r, label, bits );
+		return(r);
+	}
+
+		MATHCALL void _json( FILE *f, bool first ) const {
+			int x;
+			fprintf(f,"%s{\"thread\":%zu,\"type\":\"%s\",\"bits\":%zd",first?"":",",m_thread,m_label,m_bits);
+			for(x=0;x<COUNT;x++) fprintf(f,",\"%s\":%" PRId64,NAMES[x],(int64_t)m_c[x].load(std::memory_order_relaxed));
+			if(m_c[POOLHIT].load(std::memory_order_relaxed) || m_c[POOLMISS].load(std::memory_order_relaxed)) {	//pooling blocks only
+				for(x=0;x<BIGMATHPOOLTIERS;x++) fprintf(f,"%s%" PRId64,x?",":",\"tier_hits\":[",(int64_t)m_tierhits[x].load(std::memory_order_relaxed));
+				for(x=0;x<BIGMATHPOOLTIERS;x++) fprintf(f,"%s%" PRId64,x?",":"],\"tier_misses\":[",(int64_t)m_tiermisses[x].load(std::memory_order_relaxed));
+				fprintf(f,"]");
+			}
+			fprintf(f,"}");
+		}
+
+	//json dump of every block for live monitoring
+	MATHCALL static void dumpjson( FILE *f ) {
+		std::lock_guard<std::mutex> lock(g_lock);
+		mathstats_t *s;
+		fprintf(f,"{\"threads\":%zu,\"stats\":[",g_threadcount.load());
+		for(s=g_live.first();s;s=g_live.after(&s->m_item)) 		s->_json(f,s==g_live.first());
+		for(s=g_retired.first();s;s=g_retired.after(&s->m_item)) 	s->_json(f,!g_live.first() && s==g_retired.first());
+		fprintf(f,"]}\n");
+	}
+
+};
+
+std::mutex 				mathstats_t::g_lock;
+linkbase<mathstats_t> 	mathstats_t::g_live;
+linkbase<mathstats_t> 	mathstats_t::g_retired;
+std::atomic<size_t> 	mathstats_t::g_threadcount(0);
+thread_local size_t 	mathstats_t::g_threadid = 0;
+
+
 //
 // paging namespace to deal with callbacks from GMP memory requests
 //
@@ -209,56 +503,101 @@ struct mathpaging_t {
 
 	constexpr static size_t FLG_USED  	= 0x01;
 	constexpr static size_t FLG_MALLOC  = 0x02;
+	constexpr static size_t FLG_POOL  	= 0x04;
 
 	constexpr static size_t HDR_SZ  	= sizeof(pageheader_t);
 
+	//tiered pool of power-of-two blocks sitting between page memory and the heap (thread specific to avoid mutex locks)
+	struct pooltier_t {
+		char		*m_free;									//free blocks - link is stored in the block body
+		size_t		m_depth;									//count of free blocks held
+		__int64_t	m_returns, m_overflows;						//returned to pool, returned to heap (hits and misses are in g_stats)
+	};
+
+	constexpr static size_t POOLMINLOG2	= _bigmath_compile::log2(BIGMATHPOOLMIN);
+	constexpr static size_t POOLMAX  	= (size_t)BIGMATHPOOLMIN<<(BIGMATHPOOLTIERS-1);
+
+	static thread_local pooltier_t 		g_pool[BIGMATHPOOLTIERS];
+	static thread_local int 			g_poolstate;	//0 = unarmed, 1 = keeper armed, 2 = released at thread exit
+
+	//releases the thread's pooled tiers when the thread exits (any thread, not only those running __thread_clean)
+	struct poolkeeper_t {
+		MATHCALL inline void arm() { g_poolstate = 1; }		//first use constructs the keeper and registers its destructor
+		MATHCALL ~poolkeeper_t() { _poolrelease(); }
+	};
+
+	static thread_local poolkeeper_t 	g_poolkeeper;
+
+	//per type bank trimming - each bank type registers itself on first use on a thread
+	struct trimmer_t {
+		linkitem_single<trimmer_t> 	m_item;
+		void 						(*m_cb)(void);
+		MATHCALL trimmer_t( void (*cb)(void) ) : m_item(this), m_cb(cb) {}
+	};
+
+	static thread_local linkbase_single<trimmer_t> g_trimmers;
+
 	//variables
 	static bool g_setallocators;	//not thread local as is needed to prevent threads from duplicating GMP init
-	#ifndef BIGMATHNOMEMWARN
-	static thread_local __int64_t g_alloc_cnt, g_realloc_cnt, g_free_cnt;
-	#endif
+	static thread_local mathstats_t g_stats;	//heap traffic of this thread across all number types
 
 			//real allocation hit (avoid if possible)
 			MATHCALL inline static char* __do_alloc( size_t sz ) {
-				#ifndef BIGMATHNOMEMWARN
-				g_alloc_cnt++;
-				printf("[WARN] Bigmath malloc ");
-				printf("%zu",sz);
-				printf(" - stats:");
-				printf("%" PRId64 ",", g_alloc_cnt );
-				printf("%" PRId64 ",", g_realloc_cnt );
-				printf("%" PRId64 "\n", g_free_cnt );
-				#endif
+				g_stats.bumppaging(mathstats_t::MALLOC,sz);
 				return( reinterpret_cast<char*>( malloc(sz+HDR_SZ) ) );
 			}
 
 			//real re-allocation hit (avoid if possible)
 			MATHCALL inline static char* __do_realloc( void *ptr, size_t sz ) {
-				#ifndef BIGMATHNOMEMWARN
-				g_realloc_cnt++;
-				printf("[WARN] Bigmath realloc ");
-				printf("%zu",sz);
-				printf(" - stats:");
-				printf("%" PRId64 ",", g_alloc_cnt );
-				printf("%" PRId64 ",", g_realloc_cnt );
-				printf("%" PRId64 "\n", g_free_cnt );
-				#endif
+				g_stats.bumppaging(mathstats_t::REALLOC,sz);
 				return( reinterpret_cast<char*>( realloc(ptr, sz+HDR_SZ) ) );
 			}
 
 			//real free hit (avoid if possible)
 			MATHCALL inline static void __do_free( void *ptr ) {
-				#ifndef BIGMATHNOMEMWARN
-				g_free_cnt++;
-				printf("[WARN] Bigmath free");
-				printf(" - stats:");
-				printf("%" PRId64 ",", g_alloc_cnt );
-				printf("%" PRId64 ",", g_realloc_cnt );
-				printf("%" PRId64 "\n", g_free_cnt );
-				#endif
+				g_stats.bumppaging(mathstats_t::FREE);
 				free(ptr);
 			}
 
+			//smallest pool tier that holds sz bytes
+			MATHCALL inline static size_t __pool_tier( size_t sz ) {
+				if(sz<=BIGMATHPOOLMIN) return(0);
+				return( (sizeof(size_t)*8-__builtin_clzl(sz-1)) - POOLMINLOG2 );
+			}
+
+			//pooled allocation - heap is only hit when the tier is empty
+			MATHCALL inline static void* __pool_alloc( size_t alloc_size ) {
+				size_t 		tier = __pool_tier(alloc_size), sz = (size_t)BIGMATHPOOLMIN<<tier;
+				pooltier_t 	&t = g_pool[tier];
+				char 		*memstart;
+				if((memstart=t.m_free)) {
+					t.m_free = *reinterpret_cast<char**>(memstart+HDR_SZ);
+					t.m_depth--;
+					g_stats.bumppool(mathstats_t::POOLHIT,tier);
+				}
+				else {
+					if(g_poolstate==0) g_poolkeeper.arm();
+					memstart = __do_alloc(sz);
+					g_stats.bumppool(mathstats_t::POOLMISS,tier);
+				}
+				return(__prepare_block( memstart, FLG_USED|FLG_MALLOC|FLG_POOL, sz ));
+			}
+
+			//pooled release - heap is only hit when the tier is full or the thread is exiting
+			MATHCALL inline static void __pool_free( pageheader_t *hdr ) {
+				pooltier_t 	&t = g_pool[__pool_tier(hdr->m_sz)];
+				char 		*memstart = reinterpret_cast<char*>(hdr);
+				if(t.m_depth>=BIGMATHPOOLDEPTH || g_poolstate==2) {
+					t.m_overflows++;
+					__do_free(hdr);
+					return;
+				}
+				*reinterpret_cast<char**>(memstart+HDR_SZ) = t.m_free;
+				t.m_free = memstart;
+				t.m_depth++;
+				t.m_returns++;
+			}
+
 			//prepare block
 			MATHCALL inline static void* __prepare_block( char *memstart, size_t flags, size_t sz )  { 
 				ASSERT(sz > 0);
@@ -300,7 +639,9 @@ struct mathpaging_t {
 
 		//can be overloaded by bankpaging_t
 		inline virtual void *_alloc( size_t alloc_size ) {	
-			size_t sz = alloc_size*2;
+			size_t sz;
+			if(alloc_size<=POOLMAX) return(__pool_alloc(alloc_size));								//recycled pooled memory
+			sz = alloc_size*2;
 			return(__prepare_block( __do_alloc(sz), FLG_USED|FLG_MALLOC, sz ));
 		}
 
@@ -315,14 +656,16 @@ struct mathpaging_t {
 			hdr = __get_block_hdr(ptr);
 			if(new_size<=hdr->m_sz) return(ptr);												//fast return - no-op
 
-			sz = new_size*2;
-			sz = sz>0?sz:1;
-			if(hdr->m_flags & FLG_MALLOC) return(__update_block( __do_realloc(hdr,sz), sz ));	//realloc - expensive
+			if((hdr->m_flags & (FLG_MALLOC|FLG_POOL))==FLG_MALLOC) {
+				sz = new_size*2;
+				return(__update_block( __do_realloc(hdr,sz), sz ));								//realloc beyond pool tiers - expensive
+			}
 
 			cpsz = old_size < new_size ? old_size : new_size;
-			hdr->m_flags &= (~FLG_USED);
-			handle = __prepare_block( __do_alloc(sz), FLG_USED|FLG_MALLOC, sz );
-			if(cpsz>0) memcpy(handle,ptr,cpsz);													//copying from page mem to alloc mem - even worse
+			handle = mathpaging_t::_alloc(new_size);											//move up a pool tier (or out of page memory)
+			if(cpsz>0) memcpy(handle,ptr,cpsz);
+			if(hdr->m_flags & FLG_POOL) __pool_free(hdr);
+			else 						hdr->m_flags &= (~FLG_USED);
 			return(handle);
 		}
 
@@ -334,9 +677,37 @@ struct mathpaging_t {
 				hdr->m_flags &= (~FLG_USED);													//fast return
 				return;
 			}
+			if(hdr->m_flags & FLG_POOL) { __pool_free(hdr); return; }							//back to pool tier
 			__do_free(hdr);																		//malloc free - costly
 		}
 
+		//hand pooled blocks back to the heap
+		static void _pooltrim() {
+			size_t x;
+			char *memstart;
+			for(x=0;x<BIGMATHPOOLTIERS;x++) {
+				while((memstart=g_pool[x].m_free)) {
+					g_pool[x].m_free = *reinterpret_cast<char**>(memstart+HDR_SZ);
+					__do_free(memstart);
+				}
+				g_pool[x].m_depth = 0;
+			}
+		}
+
+		//thread exit - later releases bypass the pool
+		static void _poolrelease() {
+			_pooltrim();
+			g_poolstate = 2;
+		}
+
+	//release memory this thread holds for future numbers (empty banks of every type, pooled blocks) - numbers in use are untouched,
+	//	intended for long-running threads between sessions
+	static void trim() {
+		trimmer_t *t;
+		for(t=g_trimmers.last();t;t=g_trimmers.before(&t->m_item)) t->m_cb();
+		_pooltrim();
+	}
+
 	//global functions - should forward the parameters to thread-local functions without needing to re-push values onto stack for shared calling convention
 	static void *allocate_function( size_t alloc_size ) 								{ return(g_activeptr->_alloc(alloc_size)); }
 	static void *reallocate_function( void *ptr, size_t old_size, size_t new_size ) 	{ return(g_activeptr->_realloc(ptr,old_size,new_size)); }
@@ -348,9 +719,11 @@ thread_local mathpaging_t 	mathpaging_t::g_default;
 thread_local mathpaging_t 	*mathpaging_t::g_activeptr = &mathpaging_t::g_default;
 thread_local size_t 		mathpaging_t::g_activeindex;
 			 bool	 		mathpaging_t::g_setallocators = false;
-#ifndef BIGMATHNOMEMWARN
-thread_local __int64_t mathpaging_t::g_alloc_cnt=0, mathpaging_t::g_realloc_cnt=0, mathpaging_t::g_free_cnt=0;
-#endif
+thread_local mathpaging_t::pooltier_t	mathpaging_t::g_pool[BIGMATHPOOLTIERS];
+thread_local int 			mathpaging_t::g_poolstate = 0;
+thread_local mathstats_t 	mathpaging_t::g_stats;
+thread_local linkbase_single<mathpaging_t::trimmer_t> mathpaging_t::g_trimmers;
+thread_local mathpaging_t::poolkeeper_t	mathpaging_t::g_poolkeeper;	//defined after g_stats - thread exit destroys it first
 
 //
 // Preallocate string paging for GMP types
@@ -388,6 +761,364 @@ struct mathpagingstr_t : mathpaging_t {
 
 thread_local mathpagingstr_t mathpagingstr_t::g_strdefault;
 
+//
+// bank arenas - banks are carved from large mmap regions backed by huge pages where the system allows it, so
+//	walking many live numbers of the large types touches fewer TLB entries, and released banks are recycled in
+//	the arena instead of returning to the general heap (thread specific to avoid mutex locks, one arena per bank type)
+//
+
+struct mathbankarena_t {
+
+	constexpr static size_t REGIONSZ 	= BIGMATHARENASIZE;
+	constexpr static size_t SLOTALIGN 	= 64;		//cache line
+	constexpr static size_t HUGEMIN 	= BIGMATHARENASIZE/16;	//smaller banks stay on base pages so small types do not pin a huge page per thread
+
+	struct region_t {
+		region_t 	*m_next;
+		size_t 		m_sz;
+	};
+
+	region_t 	*m_regions;				//every region mapped by this arena
+	char 		*m_free;				//recycled slots - link is stored in the slot body
+	char 		*m_carve, *m_carveend;	//unused tail of the newest region
+	size_t 		m_live;					//slots currently handed out
+
+	//trivial construction and no destructor keeps the thread_local access free of init guards
+	constexpr mathbankarena_t() : m_regions(), m_free(), m_carve(), m_carveend(), m_live() {}
+
+		MATHCALL inline static size_t _slotsize( size_t sz ) { return((sz+SLOTALIGN-1)&~(SLOTALIGN-1)); }
+
+		//map a region - explicit huge pages first, then transparent huge pages on a huge page aligned region
+		MATHCALL static char *_map( size_t sz, bool huge ) {
+			char *p, *aligned;
+			void *handle;
+			if(!huge) {
+				handle = mmap(0,sz,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+				if(handle==MAP_FAILED) throw std::bad_alloc();
+				return(reinterpret_cast<char*>(handle));
+			}
+			#ifdef MAP_HUGETLB
+			handle = mmap(0,sz,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+			if(handle!=MAP_FAILED) return(reinterpret_cast<char*>(handle));
+			#endif
+			handle = mmap(0,sz+REGIONSZ,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+			if(handle==MAP_FAILED) throw std::bad_alloc();
+			p = reinterpret_cast<char*>(handle);
+			aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p)+REGIONSZ-1)&~(REGIONSZ-1));
+			if(aligned>p) munmap(p,aligned-p);											//trim to alignment
+			if(aligned+sz<p+sz+REGIONSZ) munmap(aligned+sz,(p+sz+REGIONSZ)-(aligned+sz));
+			#ifdef MADV_HUGEPAGE
+			madvise(aligned,sz,MADV_HUGEPAGE);											//advisory - ignored where unsupported
+			#endif
+			return(aligned);
+		}
+
+	MATHCALL void *alloc( size_t sz, mathstats_t &stats ) {
+		char *slot;
+		region_t *r;
+		size_t slotsz, regionsz;
+		m_live++;
+		if((slot=m_free)) {
+			m_free = *reinterpret_cast<char**>(slot);
+			return(slot);
+		}
+		slotsz = _slotsize(sz);
+		if((size_t)(m_carveend-m_carve)<slotsz) {
+			regionsz = (_slotsize(sizeof(region_t))+slotsz+REGIONSZ-1)&~(REGIONSZ-1);	//at least one slot
+			r = reinterpret_cast<region_t*>(_map(regionsz,slotsz>=HUGEMIN));
+			r->m_next 	= m_regions;
+			r->m_sz 	= regionsz;
+			m_regions 	= r;
+			m_carve 	= reinterpret_cast<char*>(r)+_slotsize(sizeof(region_t));
+			m_carveend 	= reinterpret_cast<char*>(r)+regionsz;
+			stats.bump(mathstats_t::ARENAMAP);
+		}
+		slot = m_carve;
+		m_carve += slotsz;
+		return(slot);
+	}
+
+	MATHCALL inline void free( void *ptr ) {
+		*reinterpret_cast<char**>(ptr) = m_free;
+		m_free = reinterpret_cast<char*>(ptr);
+		m_live--;
+	}
+
+	//thread exit - unmap once every bank is gone (banks still alive keep the arena mapped)
+	MATHCALL void release() {
+		region_t *r, *next;
+		if(m_live) return;
+		for(r=m_regions;r;r=next) {
+			next = r->m_next;
+			munmap(r,r->m_sz);
+		}
+		m_regions = 0;
+		m_free = m_carve = m_carveend = 0;
+	}
+
+};
+
+
+//
+// per modulus precomputation - built on first use by a modular type that needs it and released with the modulus entry
+//	(R = 2^(limbs*GMP_NUMB_BITS), Montgomery form of a is aR mod n)
+//
+
+struct mathfixedbase_t;
+
+struct mathmodctx_t {
+
+	size_t 		m_limbs;	//limbs in modulus
+	mp_limb_t 	m_ninv;		//-n^-1 mod 2^GMP_NUMB_BITS
+	bool 		m_mont;		//modulus odd and above one - Montgomery form usable (otherwise R is treated as one)
+	mpz_t 		m_r2;		//R^2 mod n - converts into Montgomery form with a single reduction
+	mp_limb_t 	*m_ip;		//n^-1 mod R padded to m_limbs (multiply based REDC)
+	std::atomic<mathfixedbase_t*> m_fixed; //fixed-base exponentiation tables registered on the modulus (published whole, read lock free)
+	std::mutex 	m_fixedlock; //serializes registration so each base gets one table
+
+	MATHCALL explicit mathmodctx_t( mpz_srcptr n ) : m_limbs(mpz_size(n)), m_ninv(), m_mont(mpz_odd_p(n) && mpz_cmp_ui(n,1)>0), m_r2(), m_ip(), m_fixed() {
+		mp_limb_t inv, n0;
+		size_t x;
+		mpz_init(m_r2);
+		if(!m_mont) return;
+		n0 = mpz_getlimbn(n,0);
+		inv = n0;										//correct to 3 bits for odd n0
+		for(x=0;x<5;x++) inv *= 2-n0*inv;				//newton iteration doubles the correct bits
+		m_ninv = -inv;
+		mpz_setbit( m_r2, m_limbs*GMP_NUMB_BITS );
+		mpz_invert( m_r2, n, m_r2 );
+		m_ip = new mp_limb_t[m_limbs];
+		for(x=0;x<m_limbs;x++) m_ip[x] = mpz_getlimbn(m_r2,x);
+		mpz_set_ui( m_r2, 0 );
+		mpz_setbit( m_r2, 2*m_limbs*GMP_NUMB_BITS );
+		mpz_mod( m_r2, m_r2, n );
+	}
+
+	MATHCALL inline ~mathmodctx_t();
+
+	mathmodctx_t( const mathmodctx_t& ) = delete;
+	mathmodctx_t& operator=( const mathmodctx_t& ) = delete;
+
+	MATHCALL inline mathfixedbase_t* findfixed( mpz_srcptr base ) const;
+	MATHCALL inline mathfixedbase_t* addfixed( mpz_srcptr base, mpz_srcptr n );
+	MATHCALL inline void powprod( mpz_ptr r, const mpz_srcptr *g, const mpz_srcptr *e, size_t count, mpz_srcptr n ) const;
+
+	//r = t/R mod n for 0 <= t < nR (t is consumed as scratch, r must not alias t)
+	MATHCALL void redc( mpz_ptr r, mpz_ptr t, mpz_srcptr n ) const {
+		const mp_size_t nn = (mp_size_t)m_limbs;
+		const mp_limb_t *np = mpz_limbs_read(n);
+		mp_size_t tn = (mp_size_t)mpz_size(t), x;
+		mp_limb_t *tp, *rp, cy;
+		ASSERT(m_mont && tn<=2*nn && mpz_sgn(t)>=0);
+		tp = mpz_limbs_modify( t, 2*nn );
+		for(x=tn;x<2*nn;x++) tp[x] = 0;
+		rp = mpz_limbs_write( r, nn );
+		cy = _bigmath_gmp_hacks::mpn_redc( rp, tp, np, nn, m_ninv, m_ip );
+		if(cy || mpn_cmp(rp,np,nn)>=0) mpn_sub_n( rp, rp, np, nn );
+		mpz_limbs_finish( r, nn );
+		mpz_limbs_finish( t, 0 );
+	}
+
+	//r = a*b mod n in the modulus' working form (Montgomery for odd moduli), r may alias a or b
+	MATHCALL void mul( mpz_ptr r, mpz_srcptr a, mpz_srcptr b, mpz_ptr t, mpz_srcptr n ) const {
+		mpz_mul( t, a, b );
+		if(m_mont) 	redc( r, t, n );
+		else 		mpz_tdiv_r( r, t, n );
+	}
+
+};
+
+
+//
+// fixed-base exponentiation table - base^(2^(w*i)) for every w bit digit of the exponent, so base^e is a product of table
+//	entries: exponent digits are bucketed by value and folded from the top value down (BGMW), about bits(e)/w + 2^w
+//	multiplications and no squarings. Entries are kept in the modulus' working form and the table grows for longer exponents.
+//
+
+struct mathfixedbase_t {
+
+	mathfixedbase_t *m_next;		//next table on the same modulus
+	std::mutex 		m_lock;			//tables grow and hold scratch - one pow at a time per table (numbers on any thread share it)
+	mpz_t 			m_base;			//base reduced mod n (lookup key)
+	mpz_t 			*m_pow;			//base^(2^(w*i)) in working form
+	size_t 			m_count, m_cap;
+	int 			m_window;
+	mpz_t 			m_a, m_b, m_t;	//scratch
+	size_t 			*m_order, m_ordercap, *m_bucket;	//exponent digits and their positions bucketed by value
+
+	MATHCALL mathfixedbase_t( mpz_srcptr base, mpz_srcptr n, const mathmodctx_t &ctx ) : m_next(), m_base(), m_pow(), m_count(), m_cap(), m_window(1), m_a(), m_b(), m_t(), m_order(), m_ordercap(), m_bucket() {
+		const size_t bits = mpz_sizeinbase(n,2);
+		int w;
+		for(w=2;w<=16;w++) if((bits+w-1)/w+(((size_t)1)<<w) < (bits+m_window-1)/m_window+(((size_t)1)<<m_window)) m_window = w;	//cheapest for full-size exponents
+		mpz_inits( m_base, m_a, m_b, m_t, NULL );
+		mpz_mod( m_base, base, n );
+		m_bucket = new size_t[((size_t)1)<<m_window];
+		_grow( 1, n, ctx );
+		if(ctx.m_mont) 	{ mpz_mul_2exp( m_pow[0], m_base, ctx.m_limbs*GMP_NUMB_BITS ); mpz_mod( m_pow[0], m_pow[0], n ); }
+		else 			mpz_set( m_pow[0], m_base );
+		m_count = 1;
+	}
+
+	MATHCALL ~mathfixedbase_t() {
+		size_t x;
+		for(x=0;x<m_cap;x++) mpz_clear(m_pow[x]);
+		mpz_clears( m_base, m_a, m_b, m_t, NULL );
+		delete[] m_pow;
+		delete[] m_order;
+		delete[] m_bucket;
+	}
+
+	mathfixedbase_t( const mathfixedbase_t& ) = delete;
+	mathfixedbase_t& operator=( const mathfixedbase_t& ) = delete;
+
+	//extend to count entries
+	MATHCALL void _grow( size_t count, mpz_srcptr n, const mathmodctx_t &ctx ) {
+		mpz_t *p;
+		size_t x;
+		int y;
+		if(count>m_cap) {
+			x = m_cap?m_cap:1;
+			while(x<count) x*=2;
+			p = new mpz_t[x];
+			if(m_cap) memcpy( (void*)p, (const void*)m_pow, m_cap*sizeof(mpz_t) );	//mpz structures relocate by copy
+			for(;m_cap<x;m_cap++) mpz_init2( p[m_cap], mpz_sizeinbase(n,2) );
+			delete[] m_pow;
+			m_pow = p;
+		}
+		for(;m_count<count && m_count>0;m_count++) {
+			mpz_set( m_pow[m_count], m_pow[m_count-1] );
+			for(y=0;y<m_window;y++) ctx.mul( m_pow[m_count], m_pow[m_count], m_pow[m_count], m_t, n );
+		}
+	}
+
+	//r = base^e mod n for e >= 0
+	MATHCALL void pow( mpz_ptr r, mpz_srcptr e, mpz_srcptr n, const mathmodctx_t &ctx ) {
+		std::lock_guard<std::mutex> lock(m_lock);
+		const size_t 	digits = (mpz_sizeinbase(e,2)+m_window-1)/m_window, values = ((size_t)1)<<m_window;
+		size_t 			*val, *pos, x, d, bit, start, count;
+		bool 			seta = false, setb = false;
+		ASSERT(mpz_sgn(e)>=0);
+		if(mpz_sgn(e)==0) { mpz_set_ui( r, 1 ); mpz_tdiv_r( r, r, n ); return; }
+		_grow( digits, n, ctx );
+		if(2*digits>m_ordercap) { delete[] m_order; m_ordercap = 4*digits; m_order = new size_t[m_ordercap]; }
+		val = m_order;
+		pos = m_order+digits;
+
+		//bucket the digit positions by digit value, highest value first
+		for(x=0;x<values;x++) m_bucket[x] = 0;
+		for(x=0;x<digits;x++) {
+			bit = x*m_window;
+			d = mpz_getlimbn(e,bit/GMP_NUMB_BITS)>>(bit%GMP_NUMB_BITS);
+			if(bit%GMP_NUMB_BITS+m_window>GMP_NUMB_BITS) d |= mpz_getlimbn(e,bit/GMP_NUMB_BITS+1)<<(GMP_NUMB_BITS-bit%GMP_NUMB_BITS);
+			val[x] = d&(values-1);
+			m_bucket[val[x]]++;
+		}
+		for(start=0,d=values;d-->0;) { count = m_bucket[d]; m_bucket[d] = start; start += count; }
+		for(x=0;x<digits;x++) pos[m_bucket[val[x]]++] = x;		//m_bucket[d] is now the end of bucket d
+
+		//b = product of the entries with digit >= d, a = product of b over d
+		for(x=0,d=values-1;d>0;d--) {
+			for(;x<m_bucket[d];x++) {
+				if(setb) 	ctx.mul( m_b, m_b, m_pow[pos[x]], m_t, n );
+				else 		{ mpz_set( m_b, m_pow[pos[x]] ); setb = true; }
+			}
+			if(!setb) 		continue;
+			if(seta) 		ctx.mul( m_a, m_a, m_b, m_t, n );
+			else 			{ mpz_set( m_a, m_b ); seta = true; }
+		}
+		if(ctx.m_mont) 		{ mpz_set( m_t, m_a ); ctx.redc( r, m_t, n ); }
+		else 				mpz_set( r, m_a );
+	}
+
+};
+
+MATHCALL inline mathmodctx_t::~mathmodctx_t() {
+	mathfixedbase_t *f, *next;
+	for(f=m_fixed.load(std::memory_order_acquire);f;f=next) { next = f->m_next; delete f; }
+	mpz_clear(m_r2);
+	delete[] m_ip;
+}
+
+MATHCALL inline mathfixedbase_t* mathmodctx_t::findfixed( mpz_srcptr base ) const {
+	mathfixedbase_t *f;
+	for(f=m_fixed.load(std::memory_order_acquire);f;f=f->m_next) if(mpz_cmp(f->m_base,base)==0) return(f);
+	return(0);
+}
+
+//table for base, built only when no thread registered it first
+MATHCALL inline mathfixedbase_t* mathmodctx_t::addfixed( mpz_srcptr base, mpz_srcptr n ) {
+	std::lock_guard<std::mutex> lock(m_fixedlock);
+	mathfixedbase_t *f = findfixed( base );
+	if(f) return(f);
+	f = new mathfixedbase_t( base, n, *this );
+	f->m_next = m_fixed.load(std::memory_order_relaxed);
+	m_fixed.store(f,std::memory_order_release);
+	return(f);
+}
+
+//r = prod g[i]^e[i] mod n for e[i] >= 0 and g[i] reduced (Straus) - every base gets a table of its odd powers and a sliding
+//	window split of its exponent, then one squaring chain over the longest exponent multiplies in each window where it ends
+MATHCALL inline void mathmodctx_t::powprod( mpz_ptr r, const mpz_srcptr *g, const mpz_srcptr *e, size_t count, mpz_srcptr n ) const {
+	size_t 			bits, slots, *win, *nwin, *cur, x, y, val, b;
+	ssize_t 		i, lo;
+	mpz_t 			*tab, acc, t;
+	int 			w, ww;
+	bool 			set = false;
+
+	for(bits=0,x=0;x<count;x++) { ASSERT(mpz_sgn(e[x])>=0); if(mpz_sgn(e[x])>0 && mpz_sizeinbase(e[x],2)>bits) bits = mpz_sizeinbase(e[x],2); }
+	if(bits==0) { mpz_set_ui( r, 1 ); mpz_tdiv_r( r, r, n ); return; }
+
+	//cheapest window for the longest exponent, with the odd power tables of all bases held to 64K entries
+	for(w=1,ww=2;ww<=10 && (count<<(ww-1))<=65536;ww++) if(bits/(ww+1)+(((size_t)1)<<(ww-1)) < bits/(w+1)+(((size_t)1)<<(w-1))) w = ww;
+	slots = ((size_t)1)<<(w-1);
+	tab = new mpz_t[count*slots];
+	win = new size_t[count*2*(bits/w+1)];
+	nwin = new size_t[2*count];
+	cur = nwin+count;
+	mpz_init2( acc, 2*m_limbs*GMP_NUMB_BITS );
+	mpz_init2( t, 2*m_limbs*GMP_NUMB_BITS );
+
+	for(x=0;x<count;x++) {
+		//g, g^3, g^5 .. g^(2^w-1) in working form
+		for(y=0;y<slots;y++) mpz_init2( tab[x*slots+y], m_limbs*GMP_NUMB_BITS );
+		if(m_mont) 	{ mpz_mul( t, g[x], m_r2 ); redc( tab[x*slots], t, n ); }
+		else 		mpz_tdiv_r( tab[x*slots], g[x], n );
+		if(slots>1) mul( acc, tab[x*slots], tab[x*slots], t, n );
+		for(y=1;y<slots;y++) mul( tab[x*slots+y], tab[x*slots+y-1], acc, t, n );
+
+		//windows as (lowest bit, odd value) pairs from the top bit down
+		nwin[x] = cur[x] = 0;
+		for(i=(ssize_t)mpz_sizeinbase(e[x],2)-1;i>=0 && mpz_sgn(e[x])>0;i--) {
+			if(!mpz_tstbit(e[x],i)) continue;
+			for(lo=i-w+1<0?0:i-w+1;!mpz_tstbit(e[x],lo);lo++);
+			for(val=0,y=(size_t)i+1;y-->(size_t)lo;) val = 2*val+mpz_tstbit(e[x],y);
+			win[x*2*(bits/w+1)+2*nwin[x]] = (size_t)lo;
+			win[x*2*(bits/w+1)+2*nwin[x]+1] = val;
+			nwin[x]++;
+			i = lo;
+		}
+	}
+
+	for(b=bits;b-->0;) {
+		if(set) mul( acc, acc, acc, t, n );
+		for(x=0;x<count;x++) {
+			y = x*2*(bits/w+1)+2*cur[x];
+			if(cur[x]==nwin[x] || win[y]!=b) continue;
+			if(set) mul( acc, acc, tab[x*slots+win[y+1]/2], t, n );
+			else 	{ mpz_set( acc, tab[x*slots+win[y+1]/2] ); set = true; }
+			cur[x]++;
+		}
+	}
+	if(m_mont) 	redc( r, acc, n );
+	else 		mpz_set( r, acc );
+
+	for(x=0;x<count*slots;x++) mpz_clear(tab[x]);
+	mpz_clears( acc, t, NULL );
+	delete[] tab;
+	delete[] win;
+	delete[] nwin;
+}
+
 
 //
 // memory bank routines to speed up math objects
@@ -419,10 +1150,12 @@ struct mathbankaccess_t {
 		bank_t 							*m_bank;		//pointer back to bank that holds GMP value
 		T	 							*m_v;			//pointer to actual GMP value
 		bankentry_t						*m_maske;		//for modular numbers to point to masking number for fast moduli
-		size_t							m_refcnt;		//for modular numbers to prevent duplicating moduli
+		std::atomic<size_t>				m_refcnt;		//for modular numbers to prevent duplicating moduli (numbers may be released on any thread)
 		size_t							m_bankindex;	//index in bank
+		bankentry_t						*m_remotenext;	//link for remote free queue of owning bank (foreign thread releases)
+		std::atomic<mathmodctx_t*>		m_modctx;		//for modular numbers to hold per modulus precomputation (built on first use, published once)
 
-		MATHCALL inline bankentry_t() : m_item(this), m_bank(), m_v(), m_maske(), m_refcnt(), m_bankindex() {}
+		MATHCALL inline bankentry_t() : m_item(this), m_bank(), m_v(), m_maske(), m_refcnt(), m_bankindex(), m_remotenext(), m_modctx() {}
 
 		MATHCALL inline char *getstringmem() {
 			char *handle;
@@ -492,18 +1225,33 @@ struct mathbankaccess_t {
 		static thread_local	size_t 							g_cachestore, g_cachefetch;
 
 		static thread_local linkbase<bank_t> 				g_base, g_freebase;	//thread specific to avoid mutex locks
+		static thread_local std::atomic<size_t>				g_remotepending;	//count of entries released into this thread's banks by other threads
+		static thread_local size_t 							g_emptycount;		//empty banks retained (hysteresis)
+		static thread_local size_t 							g_banktick;			//bank allocations - clock for idle retained banks
+		static thread_local bool 							g_unloaded;			//thread cleanup ran - no more retention
+		#ifndef BIGMATHNOARENA
+		static thread_local mathbankarena_t					g_arena;			//backing memory for this thread's banks of this type
+		#endif
 							linkitem<bank_t> 				m_item, m_freeitem;
 							linkbase_single<bankentry_t> 	m_freenodebase;
+							std::atomic<size_t>				*m_owner;			//owning thread's g_remotepending - doubles as owner identity
+							std::atomic<bankentry_t*>		m_remotefree;		//lock-free multi-producer/single-consumer stack of foreign releases
 
 		T	 			m_v[BANKSIZE];
 		bankentry_t 	m_nodes[BANKSIZE];
 		size_t 			m_usedcount, m_freecount;
+		size_t 			m_idletick;					//g_banktick when this bank was retained empty
 		bankpaging_t	m_paging;					//page memory for GMP numbers
 
 		#ifndef NDEBUG
 		MATHCALL void checksafety() { SAFE(); }
 		#endif
 
+		#ifndef BIGMATHNOARENA
+		MATHCALL static void *operator new( size_t sz ) 	{ return(g_arena.alloc(sz,g_preloader.m_stats)); }
+		MATHCALL static void operator delete( void *ptr ) 	{ g_arena.free(ptr); }
+		#endif
+
 		MATHCALL inline bool isbankfree() { SAFE(); return(m_freenodebase.last() || m_usedcount<BANKSIZE); }
 
 		//arm & invoke memory functions
@@ -534,9 +1282,10 @@ struct mathbankaccess_t {
 			mathpaging_t::g_activeptr = &mathpaging_t::g_default;
 		}
 
-		MATHCALL bank_t() : m_item(this), m_freeitem(this), m_usedcount(0), m_freecount(0), m_paging() {
+		MATHCALL bank_t() : m_item(this), m_freeitem(this), m_owner(&g_remotepending), m_remotefree(0), m_usedcount(0), m_freecount(0), m_idletick(0), m_paging() {
 			SAFE()
 			size_t x;
+			g_preloader.m_stats.bump(mathstats_t::BANKNEW);
 			g_base.add(&m_item);
 			g_freebase.add(&m_freeitem);
 			for(x=0;x<BANKSIZE;x++) initvalue(x);
@@ -545,20 +1294,54 @@ struct mathbankaccess_t {
 		MATHCALL ~bank_t() {
 			SAFE()
 			size_t x;
+			g_preloader.m_stats.bump(mathstats_t::BANKDELETE);
 			g_base.remove(&m_item);
 			if(isbankfree()) g_freebase.remove(&m_freeitem);
 			for(x=0;x<BANKSIZE;x++) deinitvalue(x);
 		}
 
+			//reclaim entries released by other threads - only ever invoked by the owning thread
+			MATHCALL void _drainremote() {
+				bankentry_t *e, *next;
+				e = m_remotefree.exchange(0,std::memory_order_acquire);	//single consumer takes the whole stack - no ABA
+				while(e) {
+					next = e->m_remotenext;
+					g_preloader.m_stats.bump(mathstats_t::REMOTEFREE);
+					_freetobank(e);										//may delete this bank on the final entry
+					e = next;
+				}
+			}
+
+			//walk this thread's banks for pending foreign releases
+			MATHCALL static void _drainremoteall() {
+				bank_t *bank, *next;
+				g_remotepending.store(0,std::memory_order_relaxed);		//reset before draining so late arrivals are picked up next time
+				for(bank=g_base.first();bank;bank=next) {
+					next = g_base.after(&bank->m_item);
+					if(bank->m_remotefree.load(std::memory_order_relaxed)) bank->_drainremote();
+				}
+			}
+
 			//longer-term recycling for performance
 			MATHCALL static bankentry_t *_allocfrombank() {
 				
 				bankentry_t 	*node;
-				bank_t 			*bank = g_freebase.first();
+				bank_t 			*bank;
+
+				#ifndef BIGMATHNOREMOTEFREE
+				if(g_remotepending.load(std::memory_order_relaxed)) _drainremoteall();
+				#endif
+
+				#if BIGMATHBANKIDLE>0
+				if(((++g_banktick)&(BIGMATHBANKIDLE-1))==0 && g_emptycount) _expireidle();
+				#endif
+
+				bank = g_freebase.first();
 
 				if(bank==0) {
 					if(!(bank=new bank_t)) { throw std::bad_alloc(); }
 				}
+				else if(bank->m_usedcount==0) g_emptycount--;			//retained empty bank back in service
 
 				if((node = bank->m_freenodebase.last())==0) {
 					node = &bank->m_nodes[bank->m_usedcount++];
@@ -581,8 +1364,10 @@ struct mathbankaccess_t {
 				if((e=g_cache[g_cachefetch])) { 
 					g_cache[g_cachefetch]=0;
 					g_cachefetch=(g_cachefetch+1)&CACHEMASK;	//fast wrap for pow2 field
+					g_preloader.m_stats.bump(mathstats_t::CACHEHIT);
 					return e;
 				}
+				g_preloader.m_stats.bump(mathstats_t::CACHEMISS);
 				return(_allocfrombank());
 			}
 
@@ -592,10 +1377,62 @@ struct mathbankaccess_t {
 			//longer-term recycling for performance
 			MATHCALL void _freetobank( bankentry_t *e ) {				
 				SAFE()
+				if(isbankfree()==false) g_freebase.add(&m_freeitem);	//add bank to thread's list of banks with free elements (was full)
 				m_freenodebase.add(&e->m_item);							//add node to bank's freenodebase
-				if(isbankfree()==false) g_freebase.add(&m_freeitem);	//add bank to thread's list of banks with free elements
 				reinitvalue(e->m_bankindex); 							//reset gmp memory of this entry - prevents memory creep
-				if(++m_freecount>=m_usedcount) delete this;				//free this bank if all items free
+				if(++m_freecount>=m_usedcount) _emptied();				//all items free
+			}
+
+			//retain the bank as if freshly built (values are already initialized) or free it when enough are held
+			MATHCALL void _emptied() {
+				if(g_unloaded) { delete this; _releasearena(); return; }		//late release after thread cleanup
+				if(g_emptycount+1>BIGMATHBANKKEEP) { delete this; return; }	//not >= so BIGMATHBANKKEEP=0 builds under -Wextra
+				m_freenodebase.reset();
+				m_usedcount = m_freecount = 0;
+				m_idletick = g_banktick;
+				g_emptycount++;
+			}
+
+			//free retained empty banks that have been idle for a full period
+			MATHCALL static void _expireidle() {
+				bank_t *bank, *next;
+				for(bank=g_base.first();bank;bank=next) {
+					next = g_base.after(&bank->m_item);
+					if(bank->m_usedcount==0 && g_banktick-bank->m_idletick>=BIGMATHBANKIDLE) { g_emptycount--; delete bank; }
+				}
+			}
+
+		//flush this type's thread cache and free every empty bank (and the arena once no banks remain)
+		MATHCALL static void trim() {
+			bank_t *bank, *next;
+			size_t x;
+			for(x=0;x<CACHESIZE;x++) {
+				if(g_cache[x]) g_cache[x]->m_bank->_freetobank(g_cache[x]);
+				g_cache[x] = 0;
+			}
+			g_cachestore = g_cachefetch = 0;
+			_drainremoteall();
+			for(bank=g_base.first();bank;bank=next) {
+				next = g_base.after(&bank->m_item);
+				if(bank->m_usedcount==0) { g_emptycount--; delete bank; }
+			}
+			_releasearena();
+		}
+
+			MATHCALL inline static void _releasearena() {
+				#ifndef BIGMATHNOARENA
+				g_arena.release();
+				#endif
+			}
+
+			//foreign thread release - push onto the owning bank's stack and flag the owner
+			//	(the owner can drain e and delete the bank as soon as e is published, so nothing of the bank is read after the push)
+			MATHCALL static void _remotestore( bankentry_t *e ) {
+				bank_t 				*bank = e->m_bank;
+				std::atomic<size_t> *owner = bank->m_owner;
+				bankentry_t 		*head = bank->m_remotefree.load(std::memory_order_relaxed);
+				do { e->m_remotenext = head; } while(!bank->m_remotefree.compare_exchange_weak(head,e,std::memory_order_release,std::memory_order_relaxed));
+				owner->fetch_add(1,std::memory_order_release);
 			}
 
 			//optimized thread-local L1 recycling for performance
@@ -609,92 +1446,539 @@ struct mathbankaccess_t {
 			}
 
 		//release a number from usage by base number template
-		MATHCALL static inline void freenode( bankentry_t *e ) { _cachestore(e); }
+		MATHCALL static inline void freenode( bankentry_t *e ) {
+			#ifndef BIGMATHNOREMOTEFREE
+			if(e->m_bank->m_owner!=&g_remotepending) { _remotestore(e); return; }
+			#endif
+			_cachestore(e);
+		}
+
+	};
+
+	//automatically initializes bank states at thread start
+	struct bankpreload_t {
+
+		mathstats_t 			m_stats;	//bank counters for this type on this thread
+		mathpaging_t::trimmer_t m_trimmer;	//entry in the thread's trim list
+
+		MATHCALL static void setallocators() {
+			if(mathpaging_t::g_setallocators) return;
+			mathpaging_t::g_setallocators = true;
+			ASSERT(mp_bits_per_limb==GMP_NUMB_BITS); //ensure expected (C_ALLOC_LIMBS,C_ALLOC_BITS)
+			#ifndef BIGMATHRAWALLOC
+			mp_set_memory_functions( 
+				mathpaging_t::allocate_function,
+				mathpaging_t::reallocate_function,
+				mathpaging_t::free_function
+			);
+			#endif
+		}
+		
+		MATHCALL static void unloadcache() {
+			bank_t::trim();
+			bank_t::g_unloaded = true;
+		}
+
+#ifndef NDEBUG
+		MATHCALL static void checkcache() {
+			size_t x;
+			for(x=0;x<bank_t::CACHESIZE;x++) {
+				if(bank_t::g_cache[x]) bank_t::g_cache[x]->m_bank->checksafety();
+			}
+		}
+#endif
+
+		MATHCALL bankpreload_t() : m_stats(), m_trimmer(&bank_t::trim) {
+			size_t x;
+			m_stats.enroll(std::is_same<T,mpq_t>::value?"mpq":"mpz",S);
+			mathpaging_t::g_trimmers.add(&m_trimmer.m_item);
+			setallocators();
+			for(x=0;x<bank_t::CACHESIZE;x++) bank_t::g_cache[x] = bank_t::_allocfrombank();
+			__thread_function_cleaner_add__(&unloadcache);
+		}
+
+		MATHCALL inline void compile() {} //invoked by bank_t() constructor to prevent optimizing out the preloader
+
+	};
+
+	static thread_local bankpreload_t g_preloader;	//preloading of number cache + memory manager for entire thread at initialization of first type
+
+	//
+	// local (per instatiation)
+	//
+
+			bankentry_t *m_e, *m_etmp;	//no need to swap these during runtime
+	mutable T			*m_v, *m_vtmp;
+
+	MATHCALL inline void swap() const {
+		SAFE()
+		T *swapv;
+		swapv = m_v; m_v = m_vtmp; m_vtmp = swapv;
+	}
+
+	//take the entries of another number - the source is left empty and takes fresh entries on its next assignment
+	MATHCALL inline void steal( mathbankaccess_t &rhs ) {
+		SAFE()
+		m_e = rhs.m_e; 		 m_etmp = rhs.m_etmp;
+		m_v = rhs.m_v; 		 m_vtmp = rhs.m_vtmp;
+		rhs.m_e = rhs.m_etmp = 0;
+		rhs.m_v = rhs.m_vtmp = 0;
+	}
+
+	//trade entries with another number - our old value is released when the source is destroyed
+	MATHCALL inline void exchange( mathbankaccess_t &rhs ) {
+		SAFE()
+		bankentry_t *e, *etmp;
+		T *v, *vtmp;
+		e = m_e; etmp = m_etmp; v = m_v; vtmp = m_vtmp;
+		m_e = rhs.m_e; m_etmp = rhs.m_etmp; m_v = rhs.m_v; m_vtmp = rhs.m_vtmp;
+		rhs.m_e = e; rhs.m_etmp = etmp; rhs.m_v = v; rhs.m_vtmp = vtmp;
+	}
+};
+
+template <typename T, ssize_t S, typename CBT>
+thread_local char 														mathbankaccess_t<T,S,CBT>::bankentry_t::g_strbuffer[BIGMATHSTRBUFFERMAX*BIGMATHSTRQUEUEMAX];
+
+template <typename T, ssize_t S, typename CBT>
+thread_local size_t 													mathbankaccess_t<T,S,CBT>::bankentry_t::g_strbufferpos = 0;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local typename mathbankaccess_t<T,S,CBT>::bankentry_t 			*mathbankaccess_t<T,S,CBT>::bank_t::g_cache[CACHESIZE];
+
+template <typename T, ssize_t S, typename CBT>
+thread_local size_t 													mathbankaccess_t<T,S,CBT>::bank_t::g_cachestore=0;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local size_t			 											mathbankaccess_t<T,S,CBT>::bank_t::g_cachefetch=0;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local linkbase<typename mathbankaccess_t<T,S,CBT>::bank_t> 		mathbankaccess_t<T,S,CBT>::bank_t::g_base;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local linkbase<typename mathbankaccess_t<T,S,CBT>::bank_t> 		mathbankaccess_t<T,S,CBT>::bank_t::g_freebase;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local std::atomic<size_t>										mathbankaccess_t<T,S,CBT>::bank_t::g_remotepending(0);
+
+template <typename T, ssize_t S, typename CBT>
+thread_local size_t														mathbankaccess_t<T,S,CBT>::bank_t::g_emptycount=0;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local size_t														mathbankaccess_t<T,S,CBT>::bank_t::g_banktick=0;
+
+template <typename T, ssize_t S, typename CBT>
+thread_local bool														mathbankaccess_t<T,S,CBT>::bank_t::g_unloaded=false;
+
+#ifndef BIGMATHNOARENA
+template <typename T, ssize_t S, typename CBT>
+thread_local mathbankarena_t											mathbankaccess_t<T,S,CBT>::bank_t::g_arena;
+#endif
+
+template <typename T, ssize_t S, typename CBT>
+thread_local typename mathbankaccess_t<T,S,CBT>::bankpreload_t 			mathbankaccess_t<T,S,CBT>::g_preloader;
+
+
+//
+// fixed width binary form of numbers - limbs are copied straight between number memory and caller buffers (a limb at a
+//	time, byte swapped as needed) so wire packets are written and read without strings, mpz_export or heap traffic
+//
+
+struct mathbytes_t {
+
+	//byte orders
+	enum { BIG, LITTLE };
+
+	constexpr static size_t LIMBBYTES = sizeof(mp_limb_t);
+
+	//
+	// routines
+	//
+
+		MATHCALL inline static mp_limb_t _swap( mp_limb_t v ) {
+			if constexpr(LIMBBYTES==8) 	return (mp_limb_t)__builtin_bswap64((uint64_t)v);
+			else 						return (mp_limb_t)__builtin_bswap32((uint32_t)v);
+		}
+
+		//limb in memory order for the requested byte order
+		MATHCALL inline static mp_limb_t _order( mp_limb_t v, int endian ) {
+			#if __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+			return(endian==BIG?_swap(v):v);
+			#else
+			return(endian==BIG?v:_swap(v));
+			#endif
+		}
+
+	//bytes in the value of the n limbs at l (0 for zero)
+	MATHCALL inline static size_t bytes( const mp_limb_t *l, mp_size_t n ) {
+		mp_limb_t 	top;
+		size_t 		r;
+		while(n>0 && !l[n-1]) n--;
+		if(n==0) return(0);
+		for(top=l[n-1],r=(size_t)(n-1)*LIMBBYTES;top;top>>=8) r++;
+		return(r);
+	}
+
+	//writes the n limbs at l as exactly width bytes (zero padded), returns width or 0 when the value needs more
+	MATHCALL inline static size_t put( uint8_t *out, size_t width, const mp_limb_t *l, mp_size_t n, int endian ) {
+		const size_t 	nb = bytes( l, n ), full = nb/LIMBBYTES;
+		mp_limb_t 		v;
+		size_t 			x;
+		if(nb>width) return(0);
+		for(x=0;x<full;x++) {
+			v = _order( l[x], endian );
+			memcpy( out+(endian==BIG?width-(x+1)*LIMBBYTES:x*LIMBBYTES), &v, LIMBBYTES );
+		}
+		for(x=full*LIMBBYTES;x<nb;x++) out[endian==BIG?width-1-x:x] = (uint8_t)(l[x/LIMBBYTES]>>(8*(x%LIMBBYTES)));
+		if(endian==BIG) memset( out, 0, width-nb );
+		else 			memset( out+nb, 0, width-nb );
+		return(width);
+	}
+
+	//len bytes at in without their leading zeros (the length that remains)
+	MATHCALL inline static size_t trim( const uint8_t *in, size_t len, int endian ) {
+		if(endian==BIG) { while(len && !in[0]) { in++; len--; } }
+		else 			  while(len && !in[len-1]) len--;
+		return(len);
+	}
+
+	//reads the low n limbs of the len byte value at in (leading zeros already trimmed, bytes above n limbs are dropped),
+	//	returns the limbs written - at most n, limbs above that are left to the caller
+	MATHCALL inline static mp_size_t get( mp_limb_t *l, mp_size_t n, const uint8_t *in, size_t len, int endian ) {
+		const uint8_t 	*base = endian==BIG?in+len:in;		//byte 0 of the value is base[-1] (big) or base[0] (little)
+		size_t 			full, nb, x;
+		mp_limb_t 		v;
+		if(len>(size_t)n*LIMBBYTES) len = (size_t)n*LIMBBYTES;
+		full = len/LIMBBYTES;
+		for(x=0;x<full;x++) {
+			memcpy( &v, endian==BIG?base-(x+1)*LIMBBYTES:base+x*LIMBBYTES, LIMBBYTES );
+			l[x] = _order( v, endian );
+		}
+		if(full*LIMBBYTES==len) return((mp_size_t)full);
+		for(v=0,nb=len-full*LIMBBYTES,x=0;x<nb;x++) v |= (mp_limb_t)(endian==BIG?base[-1-(ssize_t)(full*LIMBBYTES+x)]:base[full*LIMBBYTES+x])<<(8*x);
+		l[full] = v;
+		return((mp_size_t)full+1);
+	}
+
+	//scatter/gather of count numbers as consecutive width byte fields of one packet - returns the bytes written or read,
+	//	0 when out is short or a value needs more than width (fields before it are written)
+	template <typename T>
+	MATHCALL inline static size_t exportall( std::span<uint8_t> out, const T *v, size_t count, size_t width, int endian=BIG ) {
+		size_t x;
+		if(count*width>out.size()) return(0);
+		for(x=0;x<count;x++) if(!v[x].export_to( out.subspan(x*width,width), endian, width )) return(0);
+		return(count*width);
+	}
+
+	template <typename T>
+	MATHCALL inline static size_t importall( T *v, size_t count, std::span<const uint8_t> in, size_t width, int endian=BIG ) {
+		size_t x;
+		if(count*width>in.size()) return(0);
+		for(x=0;x<count;x++) v[x].import_from( in.subspan(x*width,width), endian );
+		return(count*width);
+	}
+
+};
+
+
+//
+// read-only memory mapped file - vector files and persisted packets are parsed or imported in place instead of being read
+//	through buffers (an empty or missing file maps nothing)
+//
+
+struct mathfile_t {
+
+	const char 	*m_data;
+	size_t 		m_size;
+	bool 		m_open;
+
+	MATHCALL explicit mathfile_t( const char *path ) : m_data(0), m_size(0), m_open(false) {
+		struct stat st;
+		void 		*p;
+		int 		fd = open( path, O_RDONLY );
+		if(fd<0) return;
+		if(fstat(fd,&st)==0) {
+			m_open = true;
+			if(st.st_size>0 && (p=mmap(0,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0))!=MAP_FAILED) {
+				m_data = (const char*)p;
+				m_size = (size_t)st.st_size;
+				madvise( p, m_size, MADV_SEQUENTIAL );
+			}
+			else m_open = st.st_size==0;
+		}
+		close( fd );
+	}
+	MATHCALL ~mathfile_t() { if(m_data) munmap( (void*)m_data, m_size ); }
+
+	mathfile_t( const mathfile_t& ) = delete;
+	mathfile_t& operator=( const mathfile_t& ) = delete;
+
+	MATHCALL inline bool 						isopen() 	const 	{ return(m_open); }
+	MATHCALL inline const char* 				data() 		const 	{ return(m_data); }
+	MATHCALL inline size_t 						size() 		const 	{ return(m_size); }
+	MATHCALL inline std::span<const uint8_t> 	bytes() 	const 	{ return(std::span<const uint8_t>((const uint8_t*)m_data,m_size)); }
+
+};
+
+
+//
+// text of any length - written in pieces to a caller sink (or buffer, or std::string) instead of the fixed string queue:
+//	hex is read straight off the limbs a nibble at a time, base-64 is RFC 4648 of the big endian magnitude bytes (the
+//	export_to form) and decimal is cut by powers of ten into pieces that GMP converts (itself divide and conquer) on the stack.
+//	Text is read back the same ways (power of two bases packed straight into limbs, decimal pieces through mpn_set_str), so
+//	parsing into a number writes its bank memory directly
+//
+
+struct mathtext_t {
+
+	//bases
+	enum { DEC = 10, HEX = 16, B64 = 64 };
+
+	//receives the text in order, n chars at s per call (not terminated)
+	typedef void (*sink_t)( void *ctx, const char *s, size_t n );
+
+	constexpr static size_t CHUNK = 4096;		//most decimal digits converted in one piece (stack buffer)
+	constexpr static size_t LINE  = 256;		//hex and base-64 chars staged per sink call
+
+	//
+	// routines
+	//
+
+		struct _buffer_t { char *m_p; size_t m_n; };
 
-	};
+		MATHCALL static void _tobuffer( void *ctx, const char *s, size_t n ) 	{ _buffer_t *b = (_buffer_t*)ctx; memcpy( b->m_p+b->m_n, s, n ); b->m_n += n; }
+		MATHCALL static void _tostring( void *ctx, const char *s, size_t n ) 	{ ((std::string*)ctx)->append( s, n ); }
 
-	//automatically initializes bank states at thread start
-	struct bankpreload_t {
+		MATHCALL inline static void _zeros( sink_t sink, void *ctx, size_t n ) {
+			static const char z[64] = { '0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0',
+										'0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0','0' };
+			for(;n>sizeof(z);n-=sizeof(z)) sink( ctx, z, sizeof(z) );
+			if(n) sink( ctx, z, n );
+		}
 
-		MATHCALL static void setallocators() {
-			if(mathpaging_t::g_setallocators) return;
-			mathpaging_t::g_setallocators = true;
-			ASSERT(mp_bits_per_limb==GMP_NUMB_BITS); //ensure expected (C_ALLOC_LIMBS,C_ALLOC_BITS)
-			#ifndef BIGMATHRAWALLOC
-			mp_set_memory_functions( 
-				mathpaging_t::allocate_function,
-				mathpaging_t::reallocate_function,
-				mathpaging_t::free_function
-			);
-			#endif
+		//byte i of the magnitude in the n limbs at l
+		MATHCALL inline static unsigned _byte( const mp_limb_t *l, mp_size_t n, size_t i ) {
+			return(i/mathbytes_t::LIMBBYTES<(size_t)n?(unsigned)(l[i/mathbytes_t::LIMBBYTES]>>(8*(i%mathbytes_t::LIMBBYTES)))&0xff:0);
 		}
-		
-		MATHCALL static void unloadcache() {
-			size_t x;
-			for(x=0;x<bank_t::CACHESIZE;x++) {
-				if(bank_t::g_cache[x]) bank_t::g_cache[x]->m_bank->_freetobank(bank_t::g_cache[x]);
+
+		//digits of a >= 0, zero padded to pad digits - pieces above CHUNK digits are split at half their digits
+		MATHCALL static size_t _dec( sink_t sink, void *ctx, mpz_srcptr a, size_t pad, char *buf ) {
+			size_t 	n = mpz_sizeinbase(a,10), d, r;
+			mpz_t 	p, q, m;
+			if(n<=CHUNK) {
+				mpz_get_str( buf, 10, a );
+				n = strlen(buf);
+				if(pad>n) _zeros( sink, ctx, pad-n );
+				sink( ctx, buf, n );
+				return(pad>n?pad:n);
 			}
+			d = n/2;
+			mpz_init( p ); mpz_init( q ); mpz_init( m );
+			mpz_ui_pow_ui( p, 10, d );
+			mpz_tdiv_qr( q, m, a, p );
+			mpz_clear( p );
+			r = _dec( sink, ctx, q, pad>d?pad-d:0, buf );
+			mpz_clear( q );
+			r += _dec( sink, ctx, m, d, buf );
+			mpz_clear( m );
+			return(r);
 		}
 
-#ifndef NDEBUG
-		MATHCALL static void checkcache() {
-			size_t x;
-			for(x=0;x<bank_t::CACHESIZE;x++) {
-				if(bank_t::g_cache[x]) bank_t::g_cache[x]->m_bank->checksafety();
+		MATHCALL static size_t _hex( sink_t sink, void *ctx, const mp_limb_t *l, mp_size_t n ) {
+			static const char 	digits[] = "0123456789abcdef";
+			char 				line[LINE];
+			size_t 				c = 0, r = 0;
+			int 				shift;
+			if(!n) { sink( ctx, "0", 1 ); return(1); }
+			for(shift=GMP_NUMB_BITS-4;!((l[n-1]>>shift)&0xf);shift-=4);	//no leading zeros
+			while(n--) {
+				for(;shift>=0;shift-=4) {
+					line[c++] = digits[(l[n]>>shift)&0xf];
+					if(c==LINE) { sink( ctx, line, c ); r += c; c = 0; }
+				}
+				shift = GMP_NUMB_BITS-4;
 			}
+			if(c) sink( ctx, line, c );
+			return(r+c);
 		}
-#endif
 
-		MATHCALL bankpreload_t() {
-			size_t x;
-			setallocators();
-			for(x=0;x<bank_t::CACHESIZE;x++) bank_t::g_cache[x] = bank_t::_allocfrombank();
-			__thread_function_cleaner_add__(&unloadcache);
+		MATHCALL static size_t _b64( sink_t sink, void *ctx, const mp_limb_t *l, mp_size_t n ) {
+			static const char 	digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			const size_t 		nb = n?mathbytes_t::bytes(l,n):1;
+			char 				line[LINE];
+			size_t 				c = 0, r = 0, i, k;
+			unsigned 			g;
+			for(i=0;i<nb;i+=3) {											//i counts bytes from the top
+				for(g=0,k=0;k<3;k++) g = (g<<8)|(i+k<nb?_byte(l,n,nb-1-i-k):0);
+				line[c++] = digits[g>>18];
+				line[c++] = digits[(g>>12)&63];
+				line[c++] = i+1<nb?digits[(g>>6)&63]:'=';
+				line[c++] = i+2<nb?digits[g&63]:'=';
+				if(c==LINE) { sink( ctx, line, c ); r += c; c = 0; }		//LINE is a multiple of 4
+			}
+			if(c) sink( ctx, line, c );
+			return(r+c);
 		}
 
-		MATHCALL inline void compile() {} //invoked by bank_t() constructor to prevent optimizing out the preloader
-
-	};
+		//digit value of every char per base, -1 where it is not a digit
+		struct _digits_t {
+			signed char m_dec[256], m_hex[256], m_b64[256];
+			constexpr _digits_t() : m_dec(), m_hex(), m_b64() {
+				int c;
+				for(c=0;c<256;c++) m_dec[c] = m_hex[c] = m_b64[c] = -1;
+				for(c=0;c<10;c++) m_dec['0'+c] = m_hex['0'+c] = (signed char)c;
+				for(c=0;c<6;c++) m_hex['a'+c] = m_hex['A'+c] = (signed char)(10+c);
+				for(c=0;c<26;c++) { m_b64['A'+c] = (signed char)c; m_b64['a'+c] = (signed char)(26+c); }
+				for(c=0;c<10;c++) m_b64['0'+c] = (signed char)(52+c);
+				m_b64['+'] = 62; m_b64['/'] = 63;
+			}
+		};
 
-	static thread_local bankpreload_t g_preloader;	//preloading of number cache + memory manager for entire thread at initialization of first type
+		MATHCALL inline static const signed char* _table( int base ) {
+			static constexpr _digits_t t;
+			return(base==B64?t.m_b64:base==HEX?t.m_hex:t.m_dec);
+		}
 
-	//
-	// local (per instatiation)
-	//
+		//len digits of bits each (base 16 or 64) packed into the limbs of r from the last digit up
+		MATHCALL static void _readpow2( mpz_ptr r, const char *s, size_t len, int bits, int base ) {
+			const signed char 	*t = _table(base);
+			mp_size_t 			nl, k = 0;
+			mp_limb_t 			*l, v, acc = 0;
+			size_t 				j;
+			int 				nb = 0;
+			while(len && !t[(unsigned char)s[0]]) { s++; len--; }			//leading zeros would only widen r
+			if(!len) { mpz_set_ui( r, 0 ); return; }
+			nl = (mp_size_t)((len*bits+GMP_NUMB_BITS-1)/GMP_NUMB_BITS);
+			l = mpz_limbs_write( r, nl );
+			for(j=len;j--;) {
+				v = (mp_limb_t)t[(unsigned char)s[j]];
+				acc |= v<<nb;
+				if((nb+=bits)>=GMP_NUMB_BITS) {
+					l[k++] = acc;
+					nb -= GMP_NUMB_BITS;
+					acc = v>>(bits-nb);										//bits of a digit straddling two limbs
+				}
+			}
+			if(nb) l[k] = acc;
+			mpz_limbs_finish( r, nl );
+		}
 
-			bankentry_t *m_e, *m_etmp;	//no need to swap these during runtime
-	mutable T			*m_v, *m_vtmp;
+		//len decimal digits - pieces up to CHUNK digits go through mpn_set_str from buf, longer ones are joined as hi*10^d+lo
+		MATHCALL static void _readdec( mpz_ptr r, const char *s, size_t len, unsigned char *buf ) {
+			mp_size_t 	nl;
+			size_t 		d, j;
+			mpz_t 		p, t;
+			while(len && s[0]=='0') { s++; len--; }
+			if(!len) { mpz_set_ui( r, 0 ); return; }
+			if(len<=CHUNK) {
+				for(j=0;j<len;j++) buf[j] = (unsigned char)(s[j]-'0');
+				nl = (mp_size_t)(len*10/3/GMP_NUMB_BITS+2);					//log2(10) < 10/3, plus the extra limb mpn_set_str wants
+				mpz_limbs_finish( r, mpn_set_str( mpz_limbs_write(r,nl), buf, len, 10 ) );
+				return;
+			}
+			d = len/2;
+			mpz_init( p ); mpz_init( t );
+			_readdec( r, s, len-d, buf );
+			_readdec( t, s+len-d, d, buf );
+			mpz_ui_pow_ui( p, 10, d );
+			mpz_mul( r, r, p );
+			mpz_add( r, r, t );
+			mpz_clear( p ); mpz_clear( t );
+		}
 
-	MATHCALL inline void swap() const {
-		SAFE()
-		T *swapv;
-		swapv = m_v; m_v = m_vtmp; m_vtmp = swapv;
+	//chars of v in base, never fewer than write produces (decimal may be one over)
+	MATHCALL static size_t length( mpz_srcptr v, int base = DEC ) {
+		const size_t sign = mpz_sgn(v)<0?1:0;
+		if(base==B64) return(sign+4*(((mpz_size(v)?mathbytes_t::bytes(mpz_limbs_read(v),(mp_size_t)mpz_size(v)):1)+2)/3));
+		return(sign+mpz_sizeinbase(v,base==HEX?16:10));
 	}
-};
 
-template <typename T, ssize_t S, typename CBT>
-thread_local char 														mathbankaccess_t<T,S,CBT>::bankentry_t::g_strbuffer[BIGMATHSTRBUFFERMAX*BIGMATHSTRQUEUEMAX];
+	//text of v in base (DEC, HEX or B64) to the sink, returns the chars written
+	MATHCALL static size_t write( sink_t sink, void *ctx, mpz_srcptr v, int base = DEC ) {
+		char 	buf[CHUNK+2];
+		mpz_t 	a;
+		size_t 	r = 0;
+		if(mpz_sgn(v)<0) { sink( ctx, "-", 1 ); r = 1; }
+		if(base==HEX) return(r+_hex( sink, ctx, mpz_limbs_read(v), (mp_size_t)mpz_size(v) ));
+		if(base==B64) return(r+_b64( sink, ctx, mpz_limbs_read(v), (mp_size_t)mpz_size(v) ));
+		return(r+_dec( sink, ctx, mpz_roinit_n( a, mpz_limbs_read(v), (mp_size_t)mpz_size(v) ), 0, buf ));	//magnitude in place
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local size_t 													mathbankaccess_t<T,S,CBT>::bankentry_t::g_strbufferpos = 0;
+	//text of v terminated in out, returns its length or 0 when cap is below length(v)+1
+	MATHCALL static size_t format( char *out, size_t cap, mpz_srcptr v, int base = DEC ) {
+		_buffer_t b = { out, 0 };
+		if(cap<length(v,base)+1) return(0);
+		write( _tobuffer, &b, v, base );
+		out[b.m_n] = 0;
+		return(b.m_n);
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local typename mathbankaccess_t<T,S,CBT>::bankentry_t 			*mathbankaccess_t<T,S,CBT>::bank_t::g_cache[CACHESIZE];
+	MATHCALL static std::string& append( std::string &s, mpz_srcptr v, int base = DEC ) {
+		s.reserve( s.size()+length(v,base) );
+		write( _tostring, &s, v, base );
+		return(s);
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local size_t 													mathbankaccess_t<T,S,CBT>::bank_t::g_cachestore=0;
+	//bulk dumps - count numbers (any type with write) with sep after each, returns the chars written
+	template <typename T>
+	MATHCALL static size_t writeall( sink_t sink, void *ctx, const T *v, size_t count, int base = DEC, const char *sep = "\n" ) {
+		const size_t 	n = strlen(sep);
+		size_t 			x, r = 0;
+		for(x=0;x<count;x++) {
+			r += v[x].write( sink, ctx, base );
+			if(n) { sink( ctx, sep, n ); r += n; }
+		}
+		return(r);
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local size_t			 											mathbankaccess_t<T,S,CBT>::bank_t::g_cachefetch=0;
+	//value of the text at s (at most n chars) - an optional '-' then digits of base (base 0 reads hex after a 0x prefix and
+	//	decimal otherwise, base-64 may end in '=' padding), returns the chars used or 0 (r untouched) when there are no digits
+	MATHCALL static size_t read( mpz_ptr r, const char *s, size_t n, int base = 0 ) {
+		const signed char 	*t;
+		unsigned char 		buf[CHUNK];
+		size_t 				i = 0, e;
+		int 				pad;
+		bool 				neg = false;
+		if(i<n && s[i]=='-') { neg = true; i++; }
+		if((base==0 || base==HEX) && i+2<n && s[i]=='0' && (s[i+1]|0x20)=='x' && _table(HEX)[(unsigned char)s[i+2]]>=0) { base = HEX; i += 2; }
+		else if(base==0) base = DEC;
+		if(base!=DEC && base!=HEX && base!=B64) return(0);
+		for(t=_table(base),e=i;e<n && t[(unsigned char)s[e]]>=0;e++);
+		if(e==i) return(0);
+		if(base==DEC) 		_readdec( r, s+i, e-i, buf );
+		else if(base==HEX) 	_readpow2( r, s+i, e-i, 4, HEX );
+		else {
+			_readpow2( r, s+i, e-i, 6, B64 );
+			mpz_fdiv_q_2exp( r, r, (6*(e-i))%8 );							//fill bits of a partial final group
+			for(pad=0;pad<2 && e<n && s[e]=='=';pad++) e++;
+		}
+		if(neg) mpz_neg( r, r );
+		return(e);
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local linkbase<typename mathbankaccess_t<T,S,CBT>::bank_t> 		mathbankaccess_t<T,S,CBT>::bank_t::g_base;
+	//bulk loads - up to count numbers (any type with parse) apart by whitespace or commas, '#' comments run to the end of
+	//	a line, returns the count read (stops at text that is not a number)
+	template <typename T>
+	MATHCALL static size_t readall( T *v, size_t count, const char *s, size_t n, int base = 0 ) {
+		size_t i = 0, k, x;
+		for(x=0;x<count;x++) {
+			while(i<n && (s[i]==' ' || s[i]=='\t' || s[i]=='\r' || s[i]=='\n' || s[i]==',' || s[i]=='#')) {
+				if(s[i]=='#') while(i<n && s[i]!='\n') i++;
+				else i++;
+			}
+			if(i==n || !(k=v[x].parse(s+i,n-i,base))) break;
+			i += k;
+		}
+		return(x);
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local linkbase<typename mathbankaccess_t<T,S,CBT>::bank_t> 		mathbankaccess_t<T,S,CBT>::bank_t::g_freebase;
+	//readall over a memory mapped file
+	template <typename T>
+	MATHCALL static size_t loadall( T *v, size_t count, const char *path, int base = 0 ) {
+		const mathfile_t f(path);
+		return(readall( v, count, f.data(), f.size(), base ));
+	}
 
-template <typename T, ssize_t S, typename CBT>
-thread_local typename mathbankaccess_t<T,S,CBT>::bankpreload_t 			mathbankaccess_t<T,S,CBT>::g_preloader;
+};
 
 
 //
@@ -736,6 +2020,7 @@ struct biguint_t {
 	#define kill(e)   if(e) { mathbankaccess_t<mpz_t,S,biguint_t<S>>::bank_t::freenode(e); }
 
 		MATHCALL inline void _init() 												{ SAFE() make(b.m_e,b.m_v)   make(b.m_etmp,b.m_vtmp) }
+		MATHCALL inline void _revive() 												{ if(!b.m_e) _init(); }		//moved-from numbers are assignable
 	MATHCALL inline ~biguint_t() 													{ SAFE() kill(b.m_e)         kill(b.m_etmp)          }
 	//the above is deliberately *not* virtual for performance
 
@@ -748,13 +2033,25 @@ struct biguint_t {
 	MATHCALL inline biguint_t()  													{ _init(); }						//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline biguint_t( int val )  											{ _init(); this->operator=(val); }	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline biguint_t( const mpz_t *rhs ) 		 							{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline explicit biguint_t( const char *s, int base = 0 ) 				{ _init(); parse(s,strlen(s),base); }
 	MATHCALL inline biguint_t( const biguint_t &rhs ) 								{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline biguint_t( biguint_t &&rhs ) 									{ b.steal(rhs.b); }					//cppcheck-suppress noExplicitConstructor
+	#endif
 	MATHCALL inline biguint_t( const bigmod_t<_S1> &rhs )							{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline biguint_t( const bigmod_t<_S2> &rhs )							{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
 
-	MATHCALL inline 		 int 				operator=( int val ) 				{ SAFE() mpz_set_ui(b.m_v[0],(unsigned long int)val); return(val); }
-	MATHCALL inline 	     mpz_t* 			operator=( const mpz_t *rhs )		{ SAFE() mpz_set(b.m_v[0],rhs[0]);  return(b.m_v); }
-	MATHCALL inline 	 	 biguint_t<S> & 	operator=( const biguint_t<S> &rhs ){ SAFE() mpz_set(b.m_v[0],rhs.b.m_v[0]); return(*this); }				//overload to avoid structure copy errors
+	MATHCALL inline 		 int 				operator=( int val ) 				{ SAFE() _revive(); mpz_set_ui(b.m_v[0],(unsigned long int)val); return(val); }
+	MATHCALL inline 	     mpz_t* 			operator=( const mpz_t *rhs )		{ SAFE() _revive(); mpz_set(b.m_v[0],rhs[0]);  return(b.m_v); }
+	MATHCALL inline 	 	 biguint_t<S> & 	operator=( const biguint_t<S> &rhs ){ SAFE() _revive(); mpz_set(b.m_v[0],rhs.b.m_v[0]); return(*this); }				//overload to avoid structure copy errors
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline 	 	 biguint_t<S> & 	operator=( biguint_t<S> &&rhs )		{ SAFE() b.exchange(rhs.b); return(*this); }
+	#endif
+
+	//lazy expressions (bigmathexpr.h) are lowered straight into this number's memory
+	template <typename E> requires E::BIGEXPR MATHCALL inline biguint_t<S>& operator=( const E &e ) 	{ SAFE() _revive(); e._into(b); return(*this); }
+	template <typename E> requires E::BIGEXPR MATHCALL inline void operator+=( const E &e ) 			{ SAFE() e._addinto(b); }
+	template <typename E> requires E::BIGEXPR MATHCALL inline void operator-=( const E &e ) 			{ SAFE() e._subinto(b); }
 	MATHCALL inline const bigmod_t<_S1> & 	operator=( const bigmod_t<_S1> &rhs ) 	{ SAFE() this[0] = rhs.constbase(); return(rhs); }						//overload to avoid structure copy errors
 	MATHCALL inline const bigmod_t<_S2> & 	operator=( const bigmod_t<_S2> &rhs ) 	{ SAFE() this[0] = rhs.constbase(); return(rhs); }						//overload to avoid structure copy errors
 
@@ -861,6 +2158,33 @@ struct biguint_t {
 		return r;
 	}
 
+	//binary form of the magnitude (see mathbytes_t) - width 0 writes the fewest bytes (at least one), returns the bytes
+	//	written or 0 when out or width is too short
+	MATHCALL size_t export_to( std::span<uint8_t> out, int endian = mathbytes_t::BIG, size_t width = 0 ) const {
+		SAFE()
+		const mp_limb_t *l = mpz_limbs_read(b.m_v[0]);
+		const mp_size_t  n = (mp_size_t)mpz_size(b.m_v[0]);
+		if(!width) width = n?mathbytes_t::bytes(l,n):1;
+		if(width>out.size()) return(0);
+		return mathbytes_t::put( out.data(), width, l, n, endian );
+	}
+
+	//value from every byte of in (no heap traffic while it fits the number's bank memory), returns the bytes read
+	MATHCALL size_t import_from( std::span<const uint8_t> in, int endian = mathbytes_t::BIG ) {
+		SAFE()
+		const size_t 	len = mathbytes_t::trim( in.data(), in.size(), endian );
+		const uint8_t 	*p = endian==mathbytes_t::BIG?in.data()+in.size()-len:in.data();
+		const mp_size_t n = (mp_size_t)((len+mathbytes_t::LIMBBYTES-1)/mathbytes_t::LIMBBYTES);
+		if(!n) 	mpz_set_ui( b.m_v[0], 0 );
+		else 	mpz_limbs_finish( b.m_v[0], mathbytes_t::get( mpz_limbs_write(b.m_v[0],n), n, p, len, endian ) );
+		return(in.size());
+	}
+
+	//text of any length (see mathtext_t) - the string queue behind str() holds BIGMATHSTRBUFFERMAX chars at most
+	MATHCALL inline size_t 			write( mathtext_t::sink_t sink, void *ctx, int base = mathtext_t::DEC ) 	const 	{ SAFE() return mathtext_t::write( sink, ctx, b.m_v[0], base ); }
+	MATHCALL inline std::string& 	append( std::string &s, int base = mathtext_t::DEC ) 						const 	{ SAFE() return mathtext_t::append( s, b.m_v[0], base ); }
+	MATHCALL inline size_t 			parse( const char *s, size_t n, int base = 0 ) 									{ SAFE() return mathtext_t::read( b.m_v[0], s, n, base ); }		//chars used, 0 leaves the value
+
 	//
 	// global routines
 	//
@@ -909,11 +2233,22 @@ struct bigint_t : biguint_t<S> {
 	MATHCALL inline bigint_t() : biguint_t<S>()									{}							//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigint_t( int val ) : biguint_t<S>() 		 				{ this->operator=(val); }	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigint_t( const mpz_t *rhs ) : biguint_t<S>( rhs ) 			{}							//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline explicit bigint_t( const char *s, int base = 0 ) : biguint_t<S>( s, base ) {}
 	MATHCALL inline bigint_t( const bigint_t  &rhs ) : biguint_t<S>( rhs ) 		{}							//cppcheck-suppress noExplicitConstructor
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline bigint_t( bigint_t &&rhs ) : biguint_t<S>( static_cast<biguint_t<S>&&>(rhs) ) {}	//cppcheck-suppress noExplicitConstructor
+	#endif
 
-	MATHCALL inline 		 int 			operator=( int val ) 				{ SAFE() mpz_set_si( this->b.m_v[0], val ); return(val); }
+	MATHCALL inline 		 int 			operator=( int val ) 				{ SAFE() this->_revive(); mpz_set_si( this->b.m_v[0], val ); return(val); }
 	MATHCALL inline 	 	 mpz_t* 		operator=( const mpz_t *rhs )		{ _upcast()->operator=(rhs); return(this->b.m_v); }
 	MATHCALL inline       bigint_t<S> & 	operator=( const bigint_t<S> &rhs )	{ _upcast()->operator=(rhs); return(*this); } //overload to avoid structure copy errors
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline       bigint_t<S> & 	operator=( bigint_t<S> &&rhs )		{ SAFE() this->b.exchange(rhs.b); return(*this); }
+	#endif
+
+	template <typename E> requires E::BIGEXPR MATHCALL inline bigint_t<S>& operator=( const E &e ) 	{ SAFE() this->_revive(); e._into(this->b); return(*this); }
+	template <typename E> requires E::BIGEXPR MATHCALL inline void operator+=( const E &e ) 			{ SAFE() e._addinto(this->b); }
+	template <typename E> requires E::BIGEXPR MATHCALL inline void operator-=( const E &e ) 			{ SAFE() e._subinto(this->b); }
 
 		MATHCALL inline void _nop() 									const 	{}
 		MATHCALL inline int  _abs( const int rhs ) 						const 	{ SAFE() return(rhs>=0?rhs:-rhs); }
@@ -1009,6 +2344,7 @@ struct bigfrac_t {
 	#define kill(e)   if(e) { mathbankaccess_t<mpq_t,S,bigfrac_t<S>>::bank_t::freenode(e); }
 
 		MATHCALL inline void _init() 												{ SAFE() make(b.m_e,b.m_v)   make(b.m_etmp,b.m_vtmp) }
+		MATHCALL inline void _revive() 												{ if(!b.m_e) _init(); }		//moved-from numbers are assignable
 	MATHCALL inline ~bigfrac_t() 													{ SAFE() kill(b.m_e)         kill(b.m_etmp)          }
 
 	#undef make
@@ -1020,12 +2356,18 @@ struct bigfrac_t {
 	MATHCALL inline bigfrac_t( const mpz_t *rhs )  									{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigfrac_t( const mpq_t *rhs )  									{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigfrac_t( const bigfrac_t<S> &rhs )  							{ _init(); this->operator=(rhs); }	//cppcheck-suppress noExplicitConstructor
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline bigfrac_t( bigfrac_t<S> &&rhs )  								{ b.steal(rhs.b); }					//cppcheck-suppress noExplicitConstructor
+	#endif
 
-	MATHCALL inline 		int 			operator=( int val ) 					{ SAFE() mpq_set_si(b.m_v[0],val,1); 		return(val); }
-	MATHCALL inline const 	double& 		operator=( const double &val ) 			{ SAFE() mpq_set_d(b.m_v[0],val);    		return(val); }
-	MATHCALL inline const 	mpz_t* 			operator=( const mpz_t *rhs )	 		{ SAFE() mpq_set_z(b.m_v[0],rhs[0]); 		return(rhs); }
-	MATHCALL inline  	 	mpq_t* 			operator=( const mpq_t *rhs ) 			{ SAFE() mpq_set(b.m_v[0],rhs[0]);   		return(b.m_v); }
-	MATHCALL inline       	bigfrac_t<S>& 	operator=( const bigfrac_t<S> &rhs )	{ SAFE() mpq_set(b.m_v[0],rhs.b.m_v[0]); 	return(*this); }	//overload to avoid structure copy errors
+	MATHCALL inline 		int 			operator=( int val ) 					{ SAFE() _revive(); mpq_set_si(b.m_v[0],val,1); 		return(val); }
+	MATHCALL inline const 	double& 		operator=( const double &val ) 			{ SAFE() _revive(); mpq_set_d(b.m_v[0],val);    		return(val); }
+	MATHCALL inline const 	mpz_t* 			operator=( const mpz_t *rhs )	 		{ SAFE() _revive(); mpq_set_z(b.m_v[0],rhs[0]); 		return(rhs); }
+	MATHCALL inline  	 	mpq_t* 			operator=( const mpq_t *rhs ) 			{ SAFE() _revive(); mpq_set(b.m_v[0],rhs[0]);   		return(b.m_v); }
+	MATHCALL inline       	bigfrac_t<S>& 	operator=( const bigfrac_t<S> &rhs )	{ SAFE() _revive(); mpq_set(b.m_v[0],rhs.b.m_v[0]); 	return(*this); }	//overload to avoid structure copy errors
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline       	bigfrac_t<S>& 	operator=( bigfrac_t<S> &&rhs )			{ SAFE() b.exchange(rhs.b); 				return(*this); }
+	#endif
 
 		MATHCALL inline void 			_neg()		 								{ SAFE() mpq_neg(b.m_v[0],b.m_v[0]); }
 		MATHCALL inline void 			_abs()		 								{ SAFE() mpq_abs(b.m_v[0],b.m_v[0]); }
@@ -1172,15 +2514,31 @@ struct bigmod_t : biguint_t<_S> {
 			}
 
 			MATHCALL inline void _killnode( bankentry_t *ee )  const {
-				if(ee==g_defmodptr) 	g_defmodptr=0;
 				if(POW2FAST==false && POW2BITS>0) { //cppcheck-suppress knownConditionTrueFalse
 					ASSERT(ee->m_maske!=0);			//if this assert trips, ensure you are not moving non-pow2 modulis to pow2 modulis
 					ee->m_maske->m_bank->freenode(ee->m_maske);	
 				}
+				else if(POW2BITS==0) { if(ee->m_maske) ee->m_maske->m_bank->freenode(ee->m_maske); }	//Barrett reciprocal (built with the entry)
 				else ASSERT(ee->m_maske==0);		//if this assert trips, ensure you are not moving non-pow2 modulis to pow2 modulis
+				ee->m_maske = 0;
+				_killctx(ee);
 				ee->m_bank->freenode(ee);
 			}
 
+			MATHCALL inline static void _killctx( bankentry_t *ee ) {
+				delete ee->m_modctx.exchange(0,std::memory_order_acquire);
+			}
+
+			//threads sharing the entry race to build the context - the first one published wins and the others drop theirs
+			MATHCALL inline mathmodctx_t* _getctx() const {
+				mathmodctx_t *ctx = m_modptr->m_modctx.load(std::memory_order_acquire), *mine;
+				if(ctx) return(ctx);
+				mine = new mathmodctx_t( m_modptr->m_v[0] );
+				if(m_modptr->m_modctx.compare_exchange_strong(ctx,mine,std::memory_order_acq_rel,std::memory_order_acquire)) return(mine);
+				delete mine;
+				return(ctx);
+			}
+
 			MATHCALL inline void _initpow2mod( bankentry_t *r ) {
 				mpz_t &v=r->m_v[0], &vtmp=this->b.m_vtmp[0];
 				mpz_set_ui( vtmp, 1 );
@@ -1194,33 +2552,83 @@ struct bigmod_t : biguint_t<_S> {
 				}
 			} //r=(2^POW2BITS)-1
 
-			MATHCALL inline bankentry_t* _refmod( bankentry_t *ptr ) 					const 	{ ptr->m_refcnt++; return(ptr); }
-			MATHCALL inline void 		 _derefmod( bankentry_t *ptr ) 					const	{ if(--ptr->m_refcnt<=0) _killnode(ptr); }
-			MATHCALL inline void 		 _changemod( bankentry_t **a, bankentry_t *b )	const	{ b->m_refcnt++; _derefmod(a[0]); a[0]=b; }
+			//the final release may happen on a foreign thread - _killnode hands the entries back through freenode's remote path
+			MATHCALL inline bankentry_t* _refmod( bankentry_t *ptr ) 					const 	{ ptr->m_refcnt.fetch_add(1,std::memory_order_relaxed); return(ptr); }
+			MATHCALL inline void 		 _derefmod( bankentry_t *ptr ) 					const	{ if(ptr->m_refcnt.fetch_sub(1,std::memory_order_acq_rel)==1) _killnode(ptr); }
+			MATHCALL inline void 		 _changemod( bankentry_t **a, bankentry_t *b )	const	{ _refmod(b); if(a[0]) _derefmod(a[0]); a[0]=b; }
 
+			//entries are complete when handed out - numbers on other threads sharing one only ever read it
 			MATHCALL inline bankentry_t* _genmod( const mpz_t *d ) {
 				bankentry_t *r; _makenode(&r);
 				if(POW2BITS>0) 	_initpow2mod(r);
-				else 			mpz_set( r->m_v[0], d[0] );
-				r->m_refcnt=1;
+				else 			{ mpz_set( r->m_v[0], d[0] ); _initbarrett(r); }
+				r->m_refcnt.store(1,std::memory_order_relaxed);
 				return(r);
 			}
 
 			MATHCALL inline bankentry_t* _genmod( int d ) {
 				bankentry_t *r; _makenode(&r);
 				if(POW2BITS>0) 	_initpow2mod(r);
-				else 			mpz_set_si( r->m_v[0], d );
-				r->m_refcnt=1;
+				else 			{ mpz_set_si( r->m_v[0], d ); _initbarrett(r); }
+				r->m_refcnt.store(1,std::memory_order_relaxed);
 				return(r);
 			}
 
+			//the thread holds its own reference to the default modulus so a foreign thread can never release it
 			MATHCALL inline bankentry_t* _getdefmod() {
-				if(g_defmodptr==0) { return(g_defmodptr=_genmod(1)); }
+				if(g_defmodptr==0) {
+					g_defmodptr=_genmod(1);
+					__thread_function_cleaner_add__(&_releasedefmod);
+				}
 				return(_refmod(g_defmodptr));
 			}
 
+			//thread cleanup - frees directly to the bank as the number cache may already be unloaded
+			MATHCALL static void _releasedefmod() {
+				bankentry_t *ee = g_defmodptr;
+				g_defmodptr = 0;
+				if(ee->m_refcnt.fetch_sub(1,std::memory_order_acq_rel)>1) return;		//still referenced by live numbers - last release frees it
+				if(ee->m_maske) ee->m_maske->m_bank->_freetobank(ee->m_maske);
+				ee->m_maske = 0;
+				_killctx(ee);
+				ee->m_bank->_freetobank(ee);
+			}
+
 		// >>> maintain number in modulus
 
+			//the reciprocal takes the mask's place on non-pow2 modulus entries (zero when the modulus does not suit Barrett), built
+			//	on the thread creating the entry from that thread's bank
+			MATHCALL inline void _initbarrett( bankentry_t *ee ) const {
+				#ifdef BIGMATHGMPHACKSDISABLE
+				ee->m_maske = 0;
+				#else
+				mpz_srcptr 	n = ee->m_v[0];
+				mpz_ptr 	mu;
+				mp_limb_t 	*np;
+				size_t 		k = mpz_size(n);
+				_makenode( &ee->m_maske );
+				mu = ee->m_maske->m_v[0];
+				mpz_set_ui( mu, 0 );
+				if(k<2 || mpz_sgn(n)<0) return;
+				mpz_setbit( mu, 2*k*GMP_NUMB_BITS );
+				mpz_tdiv_q( mu, mu, n );
+				if(mpz_size(mu)!=k+1) { mpz_set_ui( mu, 0 ); return; }	//modulus is a power of the limb base
+				np = mpz_limbs_modify( mu, 2*(mp_size_t)k+2 )+k+1;		//zero-extended copy of the modulus past mu for the k+1 limb products
+				mpn_copyi( np, mpz_limbs_read(n), (mp_size_t)k );
+				np[k] = 0;
+				mpz_limbs_finish( mu, (mp_size_t)k+1 );
+				#endif
+			}
+
+			MATHCALL inline bool _barrett() const {
+				#ifdef BIGMATHGMPHACKSDISABLE
+				return(false);
+				#else
+				if(mpz_sgn(m_modptr->m_maske->m_v[0])==0) return(false);
+				return(_bigmath_gmp_hacks::mpz_barrett( this->b.m_vtmp[0], this->b.m_v[0], m_modptr->m_v[0], m_modptr->m_maske->m_v[0] ));
+				#endif
+			}
+
 			MATHCALL inline void _doclean() const {
 				_markclean();
 				if(POW2FAST) { //cppcheck-suppress knownConditionTrueFalse
@@ -1228,10 +2636,12 @@ struct bigmod_t : biguint_t<_S> {
 				}
 				else {
 					if(POW2BITS>0) 	{ ASSERT(m_modptr->m_maske!=0) 	mpz_and( this->b.m_v[0], this->b.m_v[0], m_modptr->m_maske->m_v[0] ); } 			//and mask for pow2 fields
-					else 			{ 								mpz_mod( this->b.m_vtmp[0], this->b.m_v[0], m_modptr->m_v[0] ); this->b.swap(); }	//actual modulus
+					else 			{ if(!_barrett()) 				mpz_mod( this->b.m_vtmp[0], this->b.m_v[0], m_modptr->m_v[0] ); this->b.swap(); }	//actual modulus
 				}
 			}
 
+			MATHCALL inline bool _ismod( const mpz_t *rhs ) 	const { return(rhs==m_modptr->m_v || mpz_cmp(rhs[0],m_modptr->m_v[0])==0); }
+
 			MATHCALL inline void _clean() 		const { if ((m_modflags&FLG_CLEAN)==0) _doclean(); 	}
 			MATHCALL inline void _markclean() 	const { m_modflags|=FLG_CLEAN;    					}
 			MATHCALL inline void _dirty() 		const { m_modflags&=(~FLG_CLEAN); 					}
@@ -1242,17 +2652,38 @@ struct bigmod_t : biguint_t<_S> {
 	MATHCALL inline bigmod_t( int rhs, 				 	const mpz_t *d 		 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_genmod(d)), 			  m_modflags(0) 			 {}	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigmod_t( int rhs, 				 	int d 		   		 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_genmod(d)), 			  m_modflags(0) 			 {}	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigmod_t( const bigmod_t &rhs				  			 ) 	: biguint_t<_S>( rhs._upcast_const()[0] ),		m_modptr(_refmod(rhs.m_modptr)),  m_modflags(rhs.m_modflags) {} //cppcheck-suppress noExplicitConstructor
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline bigmod_t( bigmod_t &&rhs				  			 	 ) 	: biguint_t<_S>( static_cast<biguint_t<_S>&&>(rhs) ), m_modptr(_refmod(rhs.m_modptr)), m_modflags(rhs.m_modflags) {} //the source keeps its modulus for later assignments
+	#endif
 	MATHCALL inline bigmod_t( int rhs,				 	bankentry_t &d 	 	 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_refmod(&d)), 	 	  	  m_modflags(0) 			 {} //cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigmod_t( const mpz_t *rhs, 		bankentry_t &d 	 	 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_refmod(&d)),		 	  m_modflags(0) 			 {}	//cppcheck-suppress noExplicitConstructor
 	MATHCALL inline bigmod_t( const mpz_t *rhs, 		const mpz_t *d 	 	 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_genmod(d)), 			  m_modflags(0) 			 {} //cppcheck-suppress noExplicitConstructor
+	MATHCALL inline bigmod_t( const char *rhs, 			const mpz_t *d 	 	 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_genmod(d)), 			  m_modflags(0) 			 {}	//reduced on use
+	MATHCALL inline bigmod_t( const char *rhs, 			bankentry_t &d 	 	 ) 	: biguint_t<_S>( rhs ), 						m_modptr(_refmod(&d)),		 	  m_modflags(0) 			 {}	//reduced on use
 	MATHCALL inline bigmod_t( bankentry_t &rhs, 		bankentry_t &d 		 )	: biguint_t<_S>( rhs.m_v ), 					m_modptr(_refmod(&d)),		  	  m_modflags(0) 			 {}	
 
-	MATHCALL inline ~bigmod_t() 															{ SAFE() _derefmod(m_modptr); }
+	MATHCALL inline ~bigmod_t() 															{ SAFE() if(m_modptr) _derefmod(m_modptr); }
 	//the above is deliberately *not* virtual for performance
 
 	MATHCALL inline 		int 					operator=( int rhs )					{ SAFE() _dirty(); 				 				    				    _upcast()->operator=(rhs); return(rhs);   		}
 	MATHCALL inline   	  	mpz_t* 					operator=( const mpz_t *rhs )			{ SAFE() _dirty(); 				 				    				    _upcast()->operator=(rhs); return(this->b.m_v); }
 	MATHCALL inline        bigmod_t<S>& 			operator=( const bigmod_t<S> &rhs )		{ SAFE() _changemod(&m_modptr,rhs.m_modptr); m_modflags=rhs.m_modflags; _upcast()->operator=(rhs); return(*this); 		} //overload to avoid structure copy errors
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline        bigmod_t<S>& 			operator=( bigmod_t<S> &&rhs )			{ SAFE() _exchange(rhs); return(*this); }
+	#endif
+
+	//lazy expressions (bigmathexpr.h) - a single reduction after the fused call
+	template <typename E> requires E::BIGEXPR MATHCALL inline bigmod_t<S>& operator=( const E &e ) 	{ SAFE() this->_revive(); e._into(this->b); _doclean(); return(*this); }
+	template <typename E> requires E::BIGEXPR MATHCALL inline void operator+=( const E &e ) 			{ SAFE() e._addinto(this->b); _doclean(); }
+	template <typename E> requires E::BIGEXPR MATHCALL inline void operator-=( const E &e ) 			{ SAFE() e._subinto(this->b); _doclean(); }
+
+		MATHCALL inline void _exchange( bigmod_t<S> &rhs ) {
+			bankentry_t *modptr = m_modptr;
+			size_t modflags = m_modflags;
+			m_modptr = rhs.m_modptr; m_modflags = rhs.m_modflags;
+			rhs.m_modptr = modptr; rhs.m_modflags = modflags;
+			this->b.exchange(rhs.b);
+		}
 
 	MATHCALL inline void neg()  															{ SAFE() _upcast()->_neg(); _dirty(); }													//dirty
 
@@ -1260,7 +2691,7 @@ struct bigmod_t : biguint_t<_S> {
 	MATHCALL inline void operator-=(  const mpz_t *rhs )  									{ SAFE() _upcast()->_sub(rhs); _dirty(); }												//dirty
 	MATHCALL inline void operator*=(  const mpz_t *rhs )  									{ SAFE() _upcast()->_mul(rhs); _doclean(); } 											//reduce now
 	MATHCALL inline void operator/=(  const mpz_t *rhs ) 	 								{ SAFE() bigmod_t<S> _rhs(rhs,m_modptr[0]); this[0]*=_rhs._inverse(); }					//multiply reduces
-	MATHCALL inline void operator%=(  const mpz_t *rhs )  									{ SAFE() _clean(); _upcast()->_mod(rhs); }												//clean - cannot expand number
+	MATHCALL inline void operator%=(  const mpz_t *rhs )  									{ SAFE() _clean(); if(!_ismod(rhs)) _upcast()->_mod(rhs); }							//clean - cannot expand number (own modulus reduced by its reciprocal)
 	MATHCALL inline void operator<<=( const mpz_t *rhs )  									{ SAFE() bigmod_t<S> _rhs(2,m_modptr[0]); this[0]*=_rhs._pow(rhs); }					//multiply reduces
 	MATHCALL inline void operator>>=( const mpz_t *rhs )  									{ SAFE() bigmod_t<S> _rhs(2,m_modptr[0]); this[0]*=_rhs._inverse()._pow(rhs); }			//multiply reduces
 	MATHCALL inline void operator&=(  const mpz_t *rhs ) 									{ SAFE() _clean(); _upcast()->_and(rhs); }												//clean - cannot expand number
@@ -1289,19 +2720,100 @@ struct bigmod_t : biguint_t<_S> {
 	MATHCALL inline explicit operator const char*			()						const	{ SAFE() _clean(); return (const char*)(_upcast_const()[0]); 	}
 	//operator const return of mpz_t is to prevent resolution ambiguity caused if non-const
 
+	MATHCALL inline size_t export_to( std::span<uint8_t> out, int endian = mathbytes_t::BIG, size_t width = 0 ) const 	{ SAFE() _clean(); return _upcast_const()->export_to(out,endian,width); 	}	//clean
+	MATHCALL inline size_t import_from( std::span<const uint8_t> in, int endian = mathbytes_t::BIG ) 					{ SAFE() _dirty(); return _upcast()->import_from(in,endian); 			}	//dirty - reduced on use
+	MATHCALL inline size_t write( mathtext_t::sink_t sink, void *ctx, int base = mathtext_t::DEC ) 					const 	{ SAFE() _clean(); return _upcast_const()->write(sink,ctx,base); 		}	//clean
+	MATHCALL inline std::string& append( std::string &s, int base = mathtext_t::DEC ) 								const 	{ SAFE() _clean(); return _upcast_const()->append(s,base); 				}	//clean
+	MATHCALL inline size_t parse( const char *s, size_t n, int base = 0 ) 												{ SAFE() _dirty(); return _upcast()->parse(s,n,base); 					}	//dirty - reduced on use
+
 	//
 	// additional modular specific routines
 	//
 
 		MATHCALL inline bigmod_t<S>& _inverse() 											{ SAFE() mpz_invert(  this->b.m_vtmp[0], this->b.m_v[0], 		 m_modptr->m_v[0] ); this->b.swap(); _markclean(); return(*this); }
-		MATHCALL inline bigmod_t<S>& _pow( const mpz_t *rhs )								{ SAFE() mpz_powm(    this->b.m_vtmp[0], this->b.m_v[0], rhs[0], m_modptr->m_v[0] ); this->b.swap(); _markclean(); return(*this); }
+		MATHCALL inline bigmod_t<S>& _pow( const mpz_t *rhs )								{ SAFE() mathfixedbase_t *f = _getfixed(rhs); if(f) f->pow( this->b.m_vtmp[0], rhs[0], m_modptr->m_v[0], *m_modptr->m_modctx.load(std::memory_order_acquire) ); else mpz_powm( this->b.m_vtmp[0], this->b.m_v[0], rhs[0], m_modptr->m_v[0] ); this->b.swap(); _markclean(); return(*this); }
 		MATHCALL inline bigmod_t<S>& _pow( int rhs )										{ SAFE() mpz_powm_ui( this->b.m_vtmp[0], this->b.m_v[0], rhs, 	 m_modptr->m_v[0] ); this->b.swap(); _markclean(); return(*this); }
 
+		//fixed-base table registered for this value (non-negative exponents only)
+		MATHCALL inline mathfixedbase_t* _getfixed( const mpz_t *rhs ) const {
+			const mathmodctx_t *ctx = m_modptr->m_modctx.load(std::memory_order_acquire);
+			if(POW2BITS>0 || ctx==0 || ctx->m_fixed.load(std::memory_order_acquire)==0 || mpz_sgn(rhs[0])<0) return(0); //cppcheck-suppress knownConditionTrueFalse
+			_clean();
+			return(ctx->findfixed(this->b.m_v[0]));
+		}
+
 	MATHCALL inline bigmod_t<S> inverse() 											const	{ SAFE() bigmod_t<S> _rhs = this[0]; return(_rhs._inverse()); }
 	MATHCALL inline bigmod_t<S> pow( const mpz_t *rhs )								const	{ SAFE() bigmod_t<S> _rhs = this[0]; return(_rhs._pow(rhs));  }
 	MATHCALL inline bigmod_t<S> pow( int rhs )										const	{ SAFE() bigmod_t<S> _rhs = this[0]; return(_rhs._pow(rhs));  }
 
-	MATHCALL inline void 			changemod( const mpz_t *rhs ) 							{ SAFE() _changemod(&m_modptr,_genmod(rhs)); _dirty(); }
+	//keeps a fixed-base table for this value on the modulus entry - pow() of any number equal to it on the same modulus then
+	//	multiplies table entries instead of squaring (session bases such as 2 against a fixed n), released with the modulus
+	MATHCALL inline void fixbase() const {
+		SAFE()
+		if(POW2BITS>0 || mpz_sgn(m_modptr->m_v[0])<=0) return; //cppcheck-suppress knownConditionTrueFalse
+		_clean();
+		_getctx()->addfixed( this->b.m_v[0], m_modptr->m_v[0] );
+	}
+
+	//prod g[i]^e[i] over bases sharing one modulus entry - a single squaring chain serves every term (products of independent
+	//	powers such as r*2^b), negative exponents and pow2 moduli multiply separate powers
+	MATHCALL inline static bigmod_t<S> powprod( const bigmod_t<S> *g, const mpz_t * const *e, size_t count ) {
+		bigmod_t<S> 	r(g[0]);
+		mpz_srcptr 		*args;
+		size_t 			x;
+		bool 			plain = POW2BITS>0 || mpz_sgn(r.m_modptr->m_v[0])<=0;
+		ASSERT(count>0);
+		for(x=0;x<count;x++) { ASSERT(g[x].m_modptr==r.m_modptr); if(mpz_sgn(e[x][0])<0) plain = true; }
+		if(plain) {
+			r = g[0].pow(e[0]);
+			for(x=1;x<count;x++) r *= g[x].pow(e[x]);
+			return(r);
+		}
+		args = new mpz_srcptr[2*count];
+		for(x=0;x<count;x++) { g[x]._clean(); args[x] = g[x].b.m_v[0]; args[count+x] = e[x][0]; }
+		r._getctx()->powprod( r.b.m_vtmp[0], args, args+count, count, r.m_modptr->m_v[0] );
+		r.b.swap();
+		r._markclean();
+		delete[] args;
+		return(r);
+	}
+
+	//inverts count values sharing one modulus entry in place with a single mpz_invert and 3(count-1) multiplies (Montgomery's
+	//	trick) - values without an inverse are left unchanged and flagged in failed (if given), the count of them is returned
+	MATHCALL inline static size_t invertall( bigmod_t<S> *v, size_t count, bool *failed=0 ) {
+		bigmod_t<S> 	*pre, inv, t;
+		size_t 			x, bad = 0;
+		if(count==0) return(0);
+		for(x=1;x<count;x++) ASSERT(v[x].m_modptr==v[0].m_modptr);
+		pre = new bigmod_t<S>[count];
+		pre[0] = v[0];
+		for(x=1;x<count;x++) { pre[x] = pre[x-1]; pre[x] *= v[x]; }		//prefix products
+		inv = pre[count-1];
+		inv._clean();
+		if(mpz_invert( inv.b.m_vtmp[0], inv.b.m_v[0], inv.m_modptr->m_v[0] )) {
+			inv.b.swap();
+			inv._markclean();
+			for(x=count-1;x>0;x--) {
+				t = inv; t *= pre[x-1];		//inverse of v[x]
+				inv *= v[x];				//inverse of the prefix below x
+				v[x] = t;
+			}
+			v[0] = inv;
+			if(failed) for(x=0;x<count;x++) failed[x] = false;
+		}
+		else {
+			for(x=0;x<count;x++) {		//some value shares a factor with the modulus - find it per element
+				v[x]._clean();
+				t = v[x];
+				if(mpz_invert( t.b.m_vtmp[0], t.b.m_v[0], t.m_modptr->m_v[0] )) { t.b.swap(); t._markclean(); v[x] = t; if(failed) failed[x] = false; }
+				else 															{ bad++; if(failed) failed[x] = true; }
+			}
+		}
+		delete[] pre;
+		return(bad);
+	}
+
+	MATHCALL inline void 			changemod( const mpz_t *rhs ) 							{ SAFE() bankentry_t *e = _genmod(rhs); _changemod(&m_modptr,e); e->m_refcnt.fetch_sub(1,std::memory_order_relaxed); _dirty(); }	//_genmod hands back the only reference
 	MATHCALL inline void 			changemod( bankentry_t &rhs ) 							{ SAFE() _changemod(&m_modptr,&rhs); _dirty(); }
 	MATHCALL inline bankentry_t&	getmodentry() 									const 	{ SAFE() return(m_modptr[0]); }
 	MATHCALL inline mpz_t*			getmod() 										const 	{ SAFE() return(m_modptr->raw()); }
@@ -1313,19 +2825,32 @@ struct bigmod_t : biguint_t<_S> {
 		static_assert(S>0,"Modular CRT should not use a base type of a power of two.");
 
 		//internal memory
-		bigmod_t<S> m_s1[sz], m_s2[sz];
+		bigmod_t<S> m_s1[sz], m_s2[sz], m_s3[sz];	//m_s3 - inverse multipliers, kept while the modulus entries are unchanged
+
+			//the multiplier reaching mod[x] is the product of the moduli below it whatever the values, so its inverse is taken
+			//	once per moduli set (the held entries cannot be released and reused while cached)
+			MATHCALL void _prepare( const bigmod_t<S> *v ) {
+				int x, y;
+				for(x=0;x<sz && &m_s3[x].getmodentry()==&v[x].getmodentry();x++);
+				if(x==sz) return;
+				m_s3[0] = bigmod_t<S>( 1, v[0].getmodentry() );
+				for(x=1;x<sz;x++) m_s3[x] = bigmod_t<S>( v[0].getmodentry(), v[x].getmodentry() );
+				for(x=1;x<sz;x++) for(y=x+1;y<sz;y++) m_s3[y]*=v[x].getmod();
+				for(x=1;x<sz;x++) m_s3[x]._inverse();
+			}
 
 		//chinese remainder optimized for big numbers - avoids big multiplies and big modulus reductions
 		MATHCALL biguint_t<SR> crt1( const bigmod_t<S> *v ) {
 			int x, y;
 			bigmod_t<S> delta;
 			biguint_t<SR> r(v[0]), scale(1);
+			_prepare(v);
 			for(x=1;x<sz;x++) {
 				m_s1[x] = bigmod_t<S>( v[0],			 	  v[x].getmodentry() );		//set all moduli to value in first mod
 				m_s2[x] = bigmod_t<S>( v[0].getmodentry(), v[x].getmodentry() );		//set all multipliers for all moduli to first mod
 			}
 			for(x=1;x<sz;x++) {
-				delta=(v[x]-m_s1[x])/m_s2[x];	//calculate steps to align to answer in field mod[x]
+				delta=(v[x]-m_s1[x])*m_s3[x];	//calculate steps to align to answer in field mod[x] - division by the multiplier
 				for(y=x+1;y<sz;y++) {
 					m_s1[y]+=m_s2[y]*delta;		//update answers in remaining mods - s2 on lefthand to prefer s2 modulus
 					m_s2[y]*=v[x].getmod();		//update multipliers in remaining mods
@@ -1350,6 +2875,206 @@ struct bigmod_t : biguint_t<_S> {
 		}		
 	};
 
+	//Garner CRT context for a fixed moduli set - every inverse and cross-modulus product is taken once at construction, so a
+	//	solve is only multiplies, adds and single-modulus reductions. The context holds plain mpz data and is never written
+	//	after construction: threads may solve against one context concurrently (the creating thread must outlive it)
+	template <ssize_t SR, int sz>
+	struct crtcontext {
+
+		static_assert(S>0,"Modular CRT should not use a base type of a power of two.");
+		static_assert(sz>1,"CRT needs at least two moduli.");
+
+		mpz_t 	m_mod[sz];			//moduli m[x]
+		mpz_t 	m_inv[sz];			//(m[0]..m[x-1])^-1 mod m[x]
+		mpz_t 	m_prod[sz];			//m[0]..m[x-1]
+		mpz_t 	m_cross[sz][sz];	//m[0]..m[x-1] mod m[y] for y > x
+
+		MATHCALL explicit crtcontext( const bigmod_t<S> *v ) : m_mod(), m_inv(), m_prod(), m_cross() {
+			int x, y;
+			for(x=0;x<sz;x++) {
+				mpz_init_set( m_mod[x], v[x].getmod()[0] );
+				mpz_init( m_inv[x] );
+				mpz_init( m_prod[x] );
+				for(y=x+1;y<sz;y++) mpz_init( m_cross[x][y] );
+			}
+			mpz_set_ui( m_prod[0], 1 );
+			for(x=1;x<sz;x++) {
+				mpz_mul( m_prod[x], m_prod[x-1], m_mod[x-1] );
+				if(!mpz_invert( m_inv[x], m_prod[x], m_mod[x] )) ASSERT(0);	//if this assert trips, the moduli are not coprime
+				for(y=x+1;y<sz;y++) mpz_mod( m_cross[x][y], m_prod[x], m_mod[y] );
+			}
+		}
+
+		MATHCALL ~crtcontext() {
+			int x, y;
+			for(x=0;x<sz;x++) {
+				mpz_clears( m_mod[x], m_inv[x], m_prod[x], NULL );
+				for(y=x+1;y<sz;y++) mpz_clear( m_cross[x][y] );
+			}
+		}
+
+		crtcontext( const crtcontext& ) = delete;
+		crtcontext& operator=( const crtcontext& ) = delete;
+
+		//r = the value below m[0]..m[sz-1] congruent to v[x] mod m[x] - mixed radix digits from the partial answer carried
+		//	forward in every remaining modulus, left unreduced until its own digit is taken (one reduction per modulus)
+		MATHCALL void crt( mpz_ptr r, const mpz_srcptr *v ) const {
+			mpz_t 	s[sz];
+			int 	x, y;
+			for(x=0;x<sz;x++) mpz_init2( s[x], 2*mpz_sizeinbase(m_mod[x],2)+2*GMP_NUMB_BITS );
+			mpz_mod( r, v[0], m_mod[0] );
+			for(y=1;y<sz;y++) mpz_set( s[y], r );
+			for(x=1;x<sz;x++) {
+				mpz_sub( s[x], v[x], s[x] );
+				mpz_mod( s[x], s[x], m_mod[x] );
+				mpz_mul( s[x], s[x], m_inv[x] );
+				mpz_mod( s[x], s[x], m_mod[x] );		//digit x
+				for(y=x+1;y<sz;y++) mpz_addmul( s[y], m_cross[x][y], s[x] );
+				mpz_addmul( r, m_prod[x], s[x] );
+			}
+			for(x=0;x<sz;x++) mpz_clear( s[x] );
+		}
+
+		MATHCALL biguint_t<SR> crt( const bigmod_t<S> *v ) const {
+			biguint_t<SR> 	r;
+			mpz_srcptr 		a[sz];
+			int 			x;
+			for(x=0;x<sz;x++) a[x] = v[x].raw()[0];
+			crt( r.raw()[0], a );
+			return r;
+		}
+	};
+
+	//batch CRT for many blocks on one moduli set - a remainder tree splits blocks into their residues and a product tree
+	//	recombines residues into blocks, so a block costs a few multiplies at each of log2(sz) levels instead of sz steps over
+	//	the whole answer. Subproducts and leaf inverses are built once and only read, blocks are shared out over threads
+	//	(outputs are sized on the calling thread so workers only touch their own scratch memory)
+	template <ssize_t SR, int sz>
+	struct crtbatch {
+
+		static_assert(S>0,"Modular CRT should not use a base type of a power of two.");
+		static_assert(sz>1,"CRT needs at least two moduli.");
+
+		constexpr static int NODES = 4*sz;		//node n has children 2n+1 and 2n+2
+
+		mpz_t 	m_tree[NODES];		//product of the moduli under each node (leaves are the moduli)
+		mpz_t 	m_inv[sz];			//(M/m[x])^-1 mod m[x] with M the product of all moduli
+		int 	m_leaf[sz];			//node holding m[x]
+
+		MATHCALL explicit crtbatch( const bigmod_t<S> *v ) : m_tree(), m_inv(), m_leaf() {
+			mpz_t 	t;
+			int 	x;
+			mpz_init( t );
+			for(x=0;x<NODES;x++) mpz_init( m_tree[x] );
+			_build( 0, 0, sz, v );
+			for(x=0;x<sz;x++) {
+				mpz_init( m_inv[x] );
+				mpz_divexact( t, m_tree[0], v[x].getmod()[0] );
+				if(mpz_invert( m_inv[x], t, v[x].getmod()[0] )==0) ASSERT(0);	//if this assert trips, the moduli are not coprime
+			}
+			mpz_clear( t );
+		}
+
+		MATHCALL ~crtbatch() {
+			int x;
+			for(x=0;x<NODES;x++) mpz_clear( m_tree[x] );
+			for(x=0;x<sz;x++) mpz_clear( m_inv[x] );
+		}
+
+		crtbatch( const crtbatch& ) = delete;
+		crtbatch& operator=( const crtbatch& ) = delete;
+
+			MATHCALL void _build( int n, int lo, int hi, const bigmod_t<S> *v ) {
+				if(hi-lo==1) { mpz_set( m_tree[n], v[lo].getmod()[0] ); m_leaf[lo] = n; return; }
+				_build( 2*n+1, lo, (lo+hi)/2, v );
+				_build( 2*n+2, (lo+hi)/2, hi, v );
+				mpz_mul( m_tree[n], m_tree[2*n+1], m_tree[2*n+2] );
+			}
+
+			//r[lo..hi) = x mod each leaf under n
+			MATHCALL void _reduce( int n, int lo, int hi, mpz_srcptr x, mpz_ptr *r, mpz_t *t ) const {
+				mpz_ptr d = hi-lo==1?r[lo]:t[n];
+				mpz_tdiv_r( d, x, m_tree[n] );
+				if(hi-lo==1) return;
+				_reduce( 2*n+1, lo, (lo+hi)/2, d, r, t );
+				_reduce( 2*n+2, (lo+hi)/2, hi, d, r, t );
+			}
+
+			//t[n] = sum over leaves x under n of v[x]*inv[x]*(node product/m[x]), below twice the node product per level - inv[x]
+			//	inverts M/m[x] under the full product M, so only the root reduced by M is a CRT result (subtree sums are not)
+			MATHCALL void _combine( int n, int lo, int hi, const mpz_srcptr *v, mpz_t *t ) const {
+				if(hi-lo==1) {
+					mpz_mul( t[n], v[lo], m_inv[lo] );
+					mpz_tdiv_r( t[n], t[n], m_tree[n] );
+					return;
+				}
+				_combine( 2*n+1, lo, (lo+hi)/2, v, t );
+				_combine( 2*n+2, (lo+hi)/2, hi, v, t );
+				mpz_mul( t[n], t[2*n+1], m_tree[2*n+2] );
+				mpz_addmul( t[n], t[2*n+2], m_tree[2*n+1] );
+			}
+
+			//blocks [begin,end) in one thread - mode 0 recombines v into r, mode 1 splits x into v
+			MATHCALL static void _work( const crtbatch *self, int mode, mpz_ptr *r, const mpz_srcptr *v, const mpz_srcptr *x, mpz_ptr *out, size_t begin, size_t end ) {
+				mpz_t 	t[NODES];
+				size_t 	b;
+				int 	y;
+				for(y=0;y<NODES;y++) mpz_init( t[y] );
+				for(b=begin;b<end;b++) {
+					if(mode==0) {
+						self->_combine( 0, 0, sz, v+b*sz, t );
+						mpz_tdiv_r( r[b], t[0], self->m_tree[0] );
+					}
+					else self->_reduce( 0, 0, sz, x[b], out+b*sz, t );
+				}
+				for(y=0;y<NODES;y++) mpz_clear( t[y] );
+			}
+
+			MATHCALL void _run( int mode, mpz_ptr *r, const mpz_srcptr *v, const mpz_srcptr *x, mpz_ptr *out, size_t count, int threads ) const {
+				std::thread 	**workers;
+				size_t 			b, step;
+				int 			y;
+				if(threads<=1 || count<2) { _work( this, mode, r, v, x, out, 0, count ); return; }
+				if((size_t)threads>count) threads = (int)count;
+				step = (count+threads-1)/threads;
+				workers = new std::thread*[threads-1];
+				for(y=0,b=step;y<threads-1;y++,b+=step) workers[y] = new std::thread( _work, this, mode, r, v, x, out, b<count?b:count, b+step<count?b+step:count );
+				_work( this, mode, r, v, x, out, 0, step );
+				for(y=0;y<threads-1;y++) { workers[y]->join(); delete workers[y]; }
+				delete[] workers;
+			}
+
+			MATHCALL static void _reserve( mpz_ptr r, mpz_srcptr n ) {
+				if((size_t)r->_mp_alloc<mpz_size(n)+1) mpz_realloc2( r, (mpz_size(n)+1)*GMP_NUMB_BITS );
+			}
+
+		//r[b] = the value below M congruent to v[b*sz+x] mod m[x], for count blocks
+		MATHCALL void crt( mpz_ptr *r, const mpz_srcptr *v, size_t count, int threads=1 ) const {
+			size_t b;
+			for(b=0;b<count;b++) _reserve( r[b], m_tree[0] );
+			_run( 0, r, v, 0, 0, count, threads );
+		}
+
+		//v[b*sz+x] = x[b] mod m[x], for count blocks
+		MATHCALL void reduce( mpz_ptr *v, const mpz_srcptr *x, size_t count, int threads=1 ) const {
+			size_t b;
+			int y;
+			for(b=0;b<count;b++) for(y=0;y<sz;y++) _reserve( v[b*sz+y], m_tree[m_leaf[y]] );
+			_run( 1, 0, 0, x, v, count, threads );
+		}
+
+		MATHCALL void crt( biguint_t<SR> *r, const bigmod_t<S> *v, size_t count, int threads=1 ) const {
+			mpz_ptr 	*rp = new mpz_ptr[count];
+			mpz_srcptr 	*vp = new mpz_srcptr[count*sz];
+			size_t 		b;
+			for(b=0;b<count*sz;b++) vp[b] = v[b].raw()[0];		//residues are cleaned here, not on the workers
+			for(b=0;b<count;b++) rp[b] = r[b].raw()[0];
+			crt( rp, vp, count, threads );
+			delete[] rp;
+			delete[] vp;
+		}
+	};
+
 };
 
 template <ssize_t S>
@@ -1370,25 +3095,284 @@ typedef bigmod_t<16384> bigmod16384_t;
 
 
 //
-// long-lived stream acceleration numbers
+// big modular number held in Montgomery form - multiplies reduce with REDC instead of a division by the modulus,
+//	conversion happens only at the boundaries (raw(), str(), comparisons, standard type operands) so long multiply
+//	chains stay in form, the modulus entry carries n' and R^2 (odd moduli - even moduli fall back to plain reduction)
 //
 
 template <ssize_t S>
-struct bigstream_t : bigmod_t<-S> {
+struct bigmont_t : private bigmod_t<S> {
 
-	static_assert(S>0,"error: bigstream_t <= 0");
+	static_assert(S>0,"error: bigmont_t requires a non power of two modulus type");
+
+	typedef typename bigmod_t<S>::bankentry_t bankentry_t;
+
+	//constants
+	constexpr static size_t FLG_MONT = 0x02;	//value currently in Montgomery form
 
 	//initialize
 	//cppcheck-suppress duplInheritedMember
-	SAFEHEAD(bigstream_t)
-	
+	SAFEHEAD(bigmont_t)
+
 	//
 	// routines
 	//
-	
-	MATHCALL inline bigstream_t() : bigmod_t<-S>() {}
-	
-	
+
+		MATHCALL inline const bigmod_t<S>* _mod_const() const { return static_cast<const bigmod_t<S>*>(this); }
+
+		//the representation is mutable in the same sense as the modular cleaning - the value it represents is unchanged
+		MATHCALL inline void _tomont() const {
+			mathmodctx_t *ctx;
+			this->_clean();
+			if(this->m_modflags&FLG_MONT) return;
+			ctx = this->_getctx();
+			if(ctx->m_mont) {
+				mpz_mul( this->b.m_vtmp[0], this->b.m_v[0], ctx->m_r2 );
+				ctx->redc( this->b.m_v[0], this->b.m_vtmp[0], this->m_modptr->m_v[0] );
+			}
+			this->m_modflags|=FLG_MONT;
+		}
+
+		MATHCALL inline void _frommont() const {
+			mathmodctx_t *ctx;
+			this->_clean();
+			if((this->m_modflags&FLG_MONT)==0) return;
+			ctx = this->_getctx();
+			if(ctx->m_mont) {
+				mpz_set( this->b.m_vtmp[0], this->b.m_v[0] );
+				ctx->redc( this->b.m_v[0], this->b.m_vtmp[0], this->m_modptr->m_v[0] );
+			}
+			this->m_modflags&=(~FLG_MONT);
+		}
+
+		//bring rhs into the same form as this (linear operations then work on either form)
+		MATHCALL inline void _align( const bigmont_t<S> &rhs ) const {
+			ASSERT(mpz_cmp(this->m_modptr->m_v[0],rhs.m_modptr->m_v[0])==0);
+			if(this->m_modflags&FLG_MONT) 	rhs._tomont();
+			else 							rhs._frommont();
+		}
+
+	MATHCALL inline bigmont_t( 										) : bigmod_t<S>() 				{}
+	MATHCALL inline bigmont_t( int rhs, 				int d 		) : bigmod_t<S>( rhs, d ) 		{}	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline bigmont_t( int rhs, 				const mpz_t *d	) : bigmod_t<S>( rhs, d ) 		{}	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline bigmont_t( const mpz_t *rhs, 		const mpz_t *d	) : bigmod_t<S>( rhs, d ) 		{}	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline bigmont_t( int rhs, 				bankentry_t &d 	) : bigmod_t<S>( rhs, d ) 		{}	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline bigmont_t( const mpz_t *rhs, 		bankentry_t &d 	) : bigmod_t<S>( rhs, d ) 		{}	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline explicit bigmont_t( const bigmod_t<S> &rhs 		) : bigmod_t<S>( rhs ) 			{}	//shares the modulus entry
+	MATHCALL inline bigmont_t( const bigmont_t &rhs 				) : bigmod_t<S>( rhs ) 			{}	//cppcheck-suppress noExplicitConstructor
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline bigmont_t( bigmont_t &&rhs 						) : bigmod_t<S>( static_cast<bigmod_t<S>&&>(rhs) ) {}	//cppcheck-suppress noExplicitConstructor
+	#endif
+
+	MATHCALL inline 		int 			operator=( int rhs )					{ SAFE() this->m_modflags&=(~FLG_MONT); return bigmod_t<S>::operator=(rhs); }
+	MATHCALL inline 		mpz_t* 			operator=( const mpz_t *rhs )			{ SAFE() this->m_modflags&=(~FLG_MONT); return bigmod_t<S>::operator=(rhs); }
+	MATHCALL inline 		bigmont_t<S>& 	operator=( const bigmont_t<S> &rhs )	{ SAFE() bigmod_t<S>::operator=(rhs); return(*this); }
+	#ifndef BIGMATHNOMOVE
+	MATHCALL inline 		bigmont_t<S>& 	operator=( bigmont_t<S> &&rhs )			{ SAFE() this->_exchange(rhs); return(*this); }
+	#endif
+
+	MATHCALL inline void neg()  													{ SAFE() bigmod_t<S>::neg(); }
+
+	MATHCALL inline void operator+=( const bigmont_t<S> &rhs )  					{ SAFE() _align(rhs); bigmod_t<S>::operator+=(rhs.b.m_v); }
+	MATHCALL inline void operator-=( const bigmont_t<S> &rhs )  					{ SAFE() _align(rhs); bigmod_t<S>::operator-=(rhs.b.m_v); }
+	MATHCALL inline void operator*=( const bigmont_t<S> &rhs )  					{ SAFE()
+		mathmodctx_t *ctx = this->_getctx();
+		_tomont(); rhs._tomont();
+		ASSERT(mpz_cmp(this->m_modptr->m_v[0],rhs.m_modptr->m_v[0])==0);
+		mpz_mul( this->b.m_vtmp[0], this->b.m_v[0], rhs.b.m_v[0] );
+		if(ctx->m_mont) { ctx->redc( this->b.m_v[0], this->b.m_vtmp[0], this->m_modptr->m_v[0] ); this->_markclean(); }
+		else 			{ this->b.swap(); this->_doclean(); }
+	}
+
+	//standard type and raw operands are plain values - scaling works in either form, offsets leave Montgomery form
+	MATHCALL inline void operator+=( const mpz_t *rhs )  							{ SAFE() _frommont(); bigmod_t<S>::operator+=(rhs); }
+	MATHCALL inline void operator-=( const mpz_t *rhs )  							{ SAFE() _frommont(); bigmod_t<S>::operator-=(rhs); }
+	MATHCALL inline void operator*=( const mpz_t *rhs )  							{ SAFE() bigmod_t<S>::operator*=(rhs); }
+	MATHCALL inline void operator+=( const int rhs ) 								{ SAFE() _frommont(); bigmod_t<S>::operator+=(rhs); }
+	MATHCALL inline void operator-=( const int rhs ) 								{ SAFE() _frommont(); bigmod_t<S>::operator-=(rhs); }
+	MATHCALL inline void operator*=( const int rhs ) 								{ SAFE() bigmod_t<S>::operator*=(rhs); }
+
+	MATHCALL inline bool _eq( const bigmont_t<S> &rhs )						const	{ _align(rhs); this->_clean(); rhs._clean(); return(mpz_cmp(this->b.m_v[0],rhs.b.m_v[0])==0); }
+	MATHCALL inline bool _eq( const mpz_t *rhs )							const	{ _frommont(); return(mpz_cmp(this->b.m_v[0],rhs[0])==0); }
+	MATHCALL inline bool _eq( const int rhs )								const	{ _frommont(); return(mpz_cmp_si(this->b.m_v[0],rhs)==0); }
+
+	MATHCALL inline 		 				mpz_t* 			raw()					const	{ SAFE() _frommont(); return (this->b.m_v); 				}
+	MATHCALL inline		 			  const char* 			str()					const	{ SAFE() _frommont(); return bigmod_t<S>::str(); 			}
+	MATHCALL inline 		 operator const mpz_t*			()						const	{ SAFE() _frommont(); return (this->b.m_v); 				}
+	MATHCALL inline explicit operator 		int				() 				 		const	{ SAFE() _frommont(); return (int)(_mod_const()[0]); 		}
+	MATHCALL inline explicit operator const char*			()						const	{ SAFE() _frommont(); return (const char*)(_mod_const()[0]); }
+	MATHCALL inline 		 		  		bigmod_t<S> 	plain()					const	{ SAFE() _frommont(); return(_mod_const()[0]); 				}
+
+	//exponentiation and inversion run on the plain value (mpz_powm already works in Montgomery form internally)
+	MATHCALL inline bigmont_t<S> inverse() 									const	{ SAFE() _frommont(); bigmont_t<S> _rhs = this[0]; _rhs._inverse(); return(_rhs); }
+	MATHCALL inline bigmont_t<S> pow( const mpz_t *rhs )					const	{ SAFE() _frommont(); bigmont_t<S> _rhs = this[0]; _rhs._pow(rhs); return(_rhs); }
+	MATHCALL inline bigmont_t<S> pow( int rhs )								const	{ SAFE() _frommont(); bigmont_t<S> _rhs = this[0]; _rhs._pow(rhs); return(_rhs); }
+	MATHCALL inline void 		 fixbase()									const	{ SAFE() _frommont(); bigmod_t<S>::fixbase(); }
+
+	MATHCALL inline void 			changemod( const mpz_t *rhs ) 							{ SAFE() _frommont(); bigmod_t<S>::changemod(rhs); }
+	MATHCALL inline void 			changemod( bankentry_t &rhs ) 							{ SAFE() _frommont(); bigmod_t<S>::changemod(rhs); }
+	MATHCALL inline bankentry_t&	getmodentry() 									const 	{ SAFE() return(this->m_modptr[0]); }
+	MATHCALL inline mpz_t*			getmod() 										const 	{ SAFE() return(this->m_modptr->raw()); }
+
+};
+
+#ifndef BIGMATHNOTYPES
+typedef bigmont_t<1024>  bigmont1024_t;
+typedef bigmont_t<2048>  bigmont2048_t;
+typedef bigmont_t<4096>  bigmont4096_t;
+typedef bigmont_t<8192>  bigmont8192_t;
+#endif
+
+
+//
+// long-lived stream acceleration numbers - arithmetic modulo 2^S in an inline limb array (no allocator, no sign, no
+//	reduction step) so the type is trivially copyable and a block of them is one contiguous allocation
+//
+
+template <ssize_t S>
+struct bigstream_t {
+
+	static_assert(S>0,"error: bigstream_t <= 0");
+	static_assert(S%GMP_NUMB_BITS==0,"error: bigstream_t must be a whole number of limbs");
+
+	//constants
+	constexpr static mp_size_t LIMBS = S/GMP_NUMB_BITS;
+
+	mp_limb_t m_l[LIMBS];
+
+	//
+	// routines
+	//
+
+		MATHCALL inline void _set( int rhs ) {
+			mpn_zero( m_l, LIMBS );
+			m_l[0] = rhs<0 ? -(mp_limb_t)rhs : (mp_limb_t)rhs;
+			if(rhs<0) mpn_neg( m_l, m_l, LIMBS );
+		}
+
+		//low S bits of the two's complement
+		MATHCALL inline void _set( const mpz_t *rhs ) {
+			mp_size_t n = (mp_size_t)mpz_size(rhs[0]);
+			n = n<LIMBS?n:LIMBS;
+			mpn_copyi( m_l, mpz_limbs_read(rhs[0]), n );
+			mpn_zero( m_l+n, LIMBS-n );
+			if(mpz_sgn(rhs[0])<0) mpn_neg( m_l, m_l, LIMBS );
+		}
+
+		MATHCALL inline void _add( int rhs ) {
+			if(rhs<0) 	mpn_sub_1( m_l, m_l, LIMBS, -(mp_limb_t)rhs );
+			else 		mpn_add_1( m_l, m_l, LIMBS, (mp_limb_t)rhs );
+		}
+
+		MATHCALL inline void _mul( int rhs ) {
+			mpn_mul_1( m_l, m_l, LIMBS, rhs<0 ? -(mp_limb_t)rhs : (mp_limb_t)rhs );
+			if(rhs<0) mpn_neg( m_l, m_l, LIMBS );
+		}
+
+		MATHCALL inline void _mul( const mp_limb_t *rhs ) {
+			mp_limb_t r[LIMBS], t[2*LIMBS];
+			_bigmath_gmp_hacks::mpn_mullo( r, m_l, rhs, LIMBS, t );
+			mpn_copyi( m_l, r, LIMBS );
+		}
+
+		MATHCALL inline void _lsh( int rhs ) {
+			const mp_size_t l = rhs/GMP_NUMB_BITS;
+			const int bits = rhs%GMP_NUMB_BITS;
+			if(rhs<0) 		{ _rsh(-rhs); return; }
+			if(l>=LIMBS) 	{ mpn_zero( m_l, LIMBS ); return; }
+			if(l) 			{ mpn_copyd( m_l+l, m_l, LIMBS-l ); mpn_zero( m_l, l ); }
+			if(bits) 		mpn_lshift( m_l+l, m_l+l, LIMBS-l, bits );
+		}
+
+		MATHCALL inline void _rsh( int rhs ) {
+			const mp_size_t l = rhs/GMP_NUMB_BITS;
+			const int bits = rhs%GMP_NUMB_BITS;
+			if(rhs<0) 		{ _lsh(-rhs); return; }
+			if(l>=LIMBS) 	{ mpn_zero( m_l, LIMBS ); return; }
+			if(l) 			{ mpn_copyi( m_l, m_l+l, LIMBS-l ); mpn_zero( m_l+LIMBS-l, l ); }
+			if(bits) 		mpn_rshift( m_l, m_l, LIMBS-l, bits );
+		}
+
+	MATHCALL inline constexpr bigstream_t() : m_l() {}
+	MATHCALL inline bigstream_t( int rhs ) 								{ _set(rhs); }	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline bigstream_t( const mpz_t *rhs ) 					{ _set(rhs); }	//cppcheck-suppress noExplicitConstructor
+	MATHCALL inline explicit bigstream_t( const char *s, int base = 0 ) : m_l() { parse(s,strlen(s),base); }
+	//copy, move and destruction are trivial
+
+	MATHCALL inline int 	operator=( int rhs )						{ _set(rhs); return(rhs); }
+	MATHCALL inline void 	operator=( const mpz_t *rhs )				{ _set(rhs); }
+
+	MATHCALL inline void neg() 											{ mpn_neg( m_l, m_l, LIMBS ); }
+
+	MATHCALL inline void operator+=( const bigstream_t<S> &rhs ) 		{ mpn_add_n( m_l, m_l, rhs.m_l, LIMBS ); }
+	MATHCALL inline void operator-=( const bigstream_t<S> &rhs ) 		{ mpn_sub_n( m_l, m_l, rhs.m_l, LIMBS ); }
+	MATHCALL inline void operator*=( const bigstream_t<S> &rhs ) 		{ _mul(rhs.m_l); }
+	MATHCALL inline void operator&=( const bigstream_t<S> &rhs ) 		{ mpn_and_n( m_l, m_l, rhs.m_l, LIMBS ); }
+	MATHCALL inline void operator|=( const bigstream_t<S> &rhs ) 		{ mpn_ior_n( m_l, m_l, rhs.m_l, LIMBS ); }
+	MATHCALL inline void operator^=( const bigstream_t<S> &rhs ) 		{ mpn_xor_n( m_l, m_l, rhs.m_l, LIMBS ); }
+
+	MATHCALL inline void operator+=( const mpz_t *rhs ) 				{ operator+=(bigstream_t<S>(rhs)); }
+	MATHCALL inline void operator-=( const mpz_t *rhs ) 				{ operator-=(bigstream_t<S>(rhs)); }
+	MATHCALL inline void operator*=( const mpz_t *rhs ) 				{ operator*=(bigstream_t<S>(rhs)); }
+
+	MATHCALL inline void operator+=( const int rhs ) 					{ _add(rhs);  }
+	MATHCALL inline void operator-=( const int rhs ) 					{ _add(-rhs); }
+	MATHCALL inline void operator*=( const int rhs ) 					{ _mul(rhs);  }
+	MATHCALL inline void operator<<=( const int rhs ) 					{ _lsh(rhs);  }
+	MATHCALL inline void operator>>=( const int rhs ) 					{ _rsh(rhs);  }
+
+	MATHCALL inline bool _eq( const bigstream_t<S> &rhs ) 		const 	{ return(mpn_cmp( m_l, rhs.m_l, LIMBS )==0); }
+	MATHCALL inline int  _cmp( const bigstream_t<S> &rhs ) 		const 	{ return(mpn_cmp( m_l, rhs.m_l, LIMBS )); }
+	MATHCALL inline bool iszero() 								const 	{ return(mpn_zero_p( m_l, LIMBS )!=0); }
+
+	//limb level access for kernels working on blocks of stream numbers
+	MATHCALL inline 	  mp_limb_t* 	limbs() 								{ return(m_l); }
+	MATHCALL inline const mp_limb_t* 	limbs() 						const 	{ return(m_l); }
+
+	//value as a general number (also the route to strings and the mpz based types)
+	MATHCALL inline void 				get( mpz_ptr r ) 				const 	{ mpn_copyi( mpz_limbs_write( r, LIMBS ), m_l, LIMBS ); mpz_limbs_finish( r, LIMBS ); }
+	MATHCALL inline biguint_t<S> 		value() 						const 	{ biguint_t<S> r; get( r.raw()[0] ); return(r); }
+	MATHCALL inline const char* 		str() 							const 	{ return((const char*)value()); }
+	MATHCALL inline explicit operator 	const char*() 					const 	{ return(str()); }
+	MATHCALL inline explicit operator 	unsigned int() 					const 	{ return((unsigned int)m_l[0]); }
+	MATHCALL inline explicit operator 	int() 							const 	{ return((int)m_l[0]); }
+
+	//binary form (see mathbytes_t) - width 0 writes all S/8 bytes, returns the bytes written or 0 when out or width is too short
+	MATHCALL inline size_t export_to( std::span<uint8_t> out, int endian = mathbytes_t::BIG, size_t width = 0 ) const {
+		if(!width) width = LIMBS*mathbytes_t::LIMBBYTES;
+		if(width>out.size()) return(0);
+		return mathbytes_t::put( out.data(), width, m_l, LIMBS, endian );
+	}
+
+	//low S bits of the value of every byte of in, returns the bytes read
+	MATHCALL inline size_t import_from( std::span<const uint8_t> in, int endian = mathbytes_t::BIG ) {
+		const size_t 	len = mathbytes_t::trim( in.data(), in.size(), endian );
+		const mp_size_t n = mathbytes_t::get( m_l, LIMBS, endian==mathbytes_t::BIG?in.data()+in.size()-len:in.data(), len, endian );
+		mpn_zero( m_l+n, LIMBS-n );
+		return(in.size());
+	}
+
+	//text of any length (see mathtext_t) read in place through a read-only mpz over the limbs
+	MATHCALL inline size_t write( mathtext_t::sink_t sink, void *ctx, int base = mathtext_t::DEC ) const {
+		mpz_t v;
+		return mathtext_t::write( sink, ctx, mpz_roinit_n( v, m_l, LIMBS ), base );
+	}
+
+	MATHCALL inline std::string& append( std::string &s, int base = mathtext_t::DEC ) const {
+		mpz_t v;
+		return mathtext_t::append( s, mpz_roinit_n( v, m_l, LIMBS ), base );
+	}
+
+	//low S bits of the text's value (two's complement when negative), returns the chars used - 0 leaves the value
+	MATHCALL inline size_t parse( const char *s, size_t n, int base = 0 ) {
+		mpz_t 	v;
+		size_t 	r;
+		mpz_init( v );
+		if((r=mathtext_t::read( v, s, n, base ))) _set( &v );
+		mpz_clear( v );
+		return(r);
+	}
+
 };
 
 #ifndef BIGMATHNOTYPES
@@ -1402,12 +3386,15 @@ typedef bigstream_t<8192>  uint8192_t;
 typedef bigstream_t<16384> uint16384_t;
 #endif
 
+static_assert(std::is_trivially_copyable<bigstream_t<128>>::value,"bigstream_t must stay trivially copyable");
+
 
 //
 // global operators
 //
 
 #include "bigmathoperators.h"
+#include "bigmathexpr.h"
 
 #undef MATHCALL
 
@@ -0,0 +1,134 @@
+/*
+The MIT License (MIT)
+
+Copyright © 2023 Zeitgeist Eater
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+ * associated documentation files (the “Software”), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ * LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//Opt-in lazy expressions: wrapping the left operand with bigexpr() records the shape of the expression instead of
+//	building temporaries, and the destination's assignment lowers it to fused GMP calls writing into its own memory
+//		r  = bigexpr(a)*b;			mpz_mul
+//		r += bigexpr(a)*b;			mpz_addmul		(-= mpz_submul)
+//		r  = bigexpr(a)*b + c;		mpz_mul + mpz_add into m_vtmp	(- c mpz_sub)
+//		r  = bigexpr(a)*b % m;		mpz_mul into m_vtmp + a single mpz_mod
+//	Modular operands are cleaned when captured. Modular destinations reduce once after the fused call.
+//	Operands are held by reference - an expression must be assigned within the statement that builds it.
+//	The saving is the by-value temporaries only: it shows at a few thousand bits and fades as the multiply dominates
+//	(no measurable gain at 8192 bits), so the library's own paths keep the plain operators.
+
+#ifndef BIGMATHEXPR_H
+#define BIGMATHEXPR_H
+
+namespace _bigmath_expr {
+
+	template <ssize_t S>
+	MATHCALL inline const mpz_t *operand( const biguint_t<S> &v ) 	{ return(v.raw()); }
+
+	template <ssize_t S>
+	MATHCALL inline const mpz_t *operand( const bigmod_t<S> &v ) 	{ v._clean(); return(v.raw()); }
+
+	MATHCALL inline const mpz_t *operand( const mpz_t *v ) 			{ return(v); }
+
+}
+
+//a*b (b may be a standard integer)
+struct bigexpr_mul_t {
+
+	constexpr static bool BIGEXPR = true;
+
+	const mpz_t *m_a, *m_b;
+	long 		 m_i;		//used when m_b is null
+
+	MATHCALL inline void _mul( mpz_ptr r ) const {
+		if(m_b) mpz_mul( r, m_a[0], m_b[0] );
+		else 	mpz_mul_si( r, m_a[0], m_i );
+	}
+
+	MATHCALL inline void _addmul( mpz_ptr r ) const {
+		if(m_b) 		mpz_addmul( r, m_a[0], m_b[0] );
+		else if(m_i<0) 	mpz_submul_ui( r, m_a[0], 0UL-(unsigned long)m_i );
+		else 			mpz_addmul_ui( r, m_a[0], (unsigned long)m_i );
+	}
+
+	MATHCALL inline void _submul( mpz_ptr r ) const {
+		if(m_b) 		mpz_submul( r, m_a[0], m_b[0] );
+		else if(m_i<0) 	mpz_addmul_ui( r, m_a[0], 0UL-(unsigned long)m_i );	//magnitude without negating LONG_MIN
+		else 			mpz_submul_ui( r, m_a[0], (unsigned long)m_i );
+	}
+
+	template <typename B> MATHCALL inline void _into( B &b ) 	const { _mul( b.m_vtmp[0] ); b.swap(); }
+	template <typename B> MATHCALL inline void _addinto( B &b ) const { _addmul( b.m_v[0] ); }
+	template <typename B> MATHCALL inline void _subinto( B &b ) const { _submul( b.m_v[0] ); }
+
+};
+
+//a*b+c or a*b-c
+struct bigexpr_muladd_t {
+
+	constexpr static bool BIGEXPR = true;
+
+	bigexpr_mul_t 	m_mul;
+	const mpz_t 	*m_c;
+	bool 			m_sub;
+
+	template <typename B> MATHCALL inline void _into( B &b ) const {
+		m_mul._mul( b.m_vtmp[0] );
+		if(m_sub) 	mpz_sub( b.m_vtmp[0], b.m_vtmp[0], m_c[0] );
+		else 		mpz_add( b.m_vtmp[0], b.m_vtmp[0], m_c[0] );
+		b.swap();
+	}
+
+};
+
+//a*b mod m (floor modulus, non-negative for positive m)
+struct bigexpr_mulmod_t {
+
+	constexpr static bool BIGEXPR = true;
+
+	bigexpr_mul_t 	m_mul;
+	const mpz_t 	*m_m;
+
+	template <typename B> MATHCALL inline void _into( B &b ) const {
+		m_mul._mul( b.m_vtmp[0] );
+		mpz_mod( b.m_v[0], b.m_vtmp[0], m_m[0] );
+	}
+
+};
+
+//captured left operand
+struct bigexpr_t {
+	const mpz_t *m_a;
+};
+
+template <typename N>
+MATHCALL inline bigexpr_t bigexpr( const N &a ) 												{ return(bigexpr_t{ _bigmath_expr::operand(a) }); }
+
+template <typename N>
+MATHCALL inline bigexpr_mul_t operator*( const bigexpr_t &lhs, const N &rhs ) 					{ return(bigexpr_mul_t{ lhs.m_a, _bigmath_expr::operand(rhs), 0 }); }
+MATHCALL inline bigexpr_mul_t operator*( const bigexpr_t &lhs, const int rhs ) 					{ return(bigexpr_mul_t{ lhs.m_a, 0, rhs }); }
+MATHCALL inline bigexpr_mul_t operator*( const bigexpr_t &lhs, const long rhs ) 				{ return(bigexpr_mul_t{ lhs.m_a, 0, rhs }); }
+
+template <typename N>
+MATHCALL inline bigexpr_muladd_t operator+( const bigexpr_mul_t &lhs, const N &rhs ) 			{ return(bigexpr_muladd_t{ lhs, _bigmath_expr::operand(rhs), false }); }
+
+template <typename N>
+MATHCALL inline bigexpr_muladd_t operator-( const bigexpr_mul_t &lhs, const N &rhs ) 			{ return(bigexpr_muladd_t{ lhs, _bigmath_expr::operand(rhs), true }); }
+
+template <typename N>
+MATHCALL inline bigexpr_mulmod_t operator%( const bigexpr_mul_t &lhs, const N &rhs ) 			{ return(bigexpr_mulmod_t{ lhs, _bigmath_expr::operand(rhs) }); }
+
+#endif
@@ -723,5 +723,146 @@ template <ssize_t S>
 MATHCALL inline bigmod_t<S> operator^( const int lhs, bigmod_t<S> rhs ) 						{ rhs^=lhs; return(rhs); }
 
 
-#endif
+//
+// bigmont overloads (exact types so the bigmod overloads never slice the Montgomery form away)
+//
+
+
+//single standing operators
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator-( bigmont_t<S> lhs ) 									{ lhs.neg(); return(lhs); }
+
+
+//same-type overloads
+
+template <ssize_t S>
+MATHCALL inline bool operator!=( const bigmont_t<S> &lhs, const bigmont_t<S> &rhs ) 			{ return !lhs._eq(rhs); }
+
+template <ssize_t S>
+MATHCALL inline bool operator==( const bigmont_t<S> &lhs, const bigmont_t<S> &rhs ) 			{ return lhs._eq(rhs);  }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator+( bigmont_t<S> lhs, const bigmont_t<S> &rhs ) 			{ lhs+=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator-( bigmont_t<S> lhs, const bigmont_t<S> &rhs ) 			{ lhs-=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator*( bigmont_t<S> lhs, const bigmont_t<S> &rhs ) 			{ lhs*=rhs; return(lhs); }
+
+
+//cross-type overloads
+
+template <ssize_t S>
+MATHCALL inline bool operator!=( const bigmont_t<S> &lhs, const mpz_t *rhs ) 					{ return !lhs._eq(rhs); }
+
+template <ssize_t S>
+MATHCALL inline bool operator==( const bigmont_t<S> &lhs, const mpz_t *rhs ) 					{ return lhs._eq(rhs);  }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator+( bigmont_t<S> lhs, const mpz_t *rhs ) 					{ lhs+=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator-( bigmont_t<S> lhs, const mpz_t *rhs ) 					{ lhs-=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator*( bigmont_t<S> lhs, const mpz_t *rhs ) 					{ lhs*=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bool operator!=( const bigmont_t<S> &lhs, const int rhs ) 						{ return !lhs._eq(rhs); }
+
+template <ssize_t S>
+MATHCALL inline bool operator==( const bigmont_t<S> &lhs, const int rhs ) 						{ return lhs._eq(rhs);  }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator+( bigmont_t<S> lhs, const int rhs ) 						{ lhs+=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator-( bigmont_t<S> lhs, const int rhs ) 						{ lhs-=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator*( bigmont_t<S> lhs, const int rhs ) 						{ lhs*=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigmont_t<S> operator*( const int lhs, bigmont_t<S> rhs ) 						{ rhs*=lhs; return(rhs); }
+
+
+//
+// bigstream overloads (fixed width, wrap-around modulo 2^S)
+//
+
 
+//single standing operators
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator-( bigstream_t<S> lhs ) 								{ lhs.neg(); return(lhs); }
+
+
+//same-type overloads
+
+template <ssize_t S>
+MATHCALL inline bool operator!=( const bigstream_t<S> &lhs, const bigstream_t<S> &rhs ) 		{ return !lhs._eq(rhs); }
+
+template <ssize_t S>
+MATHCALL inline bool operator==( const bigstream_t<S> &lhs, const bigstream_t<S> &rhs ) 		{ return lhs._eq(rhs);  }
+
+template <ssize_t S>
+MATHCALL inline bool operator>( const bigstream_t<S> &lhs, const bigstream_t<S> &rhs ) 		{ return lhs._cmp(rhs)>0;  }
+
+template <ssize_t S>
+MATHCALL inline bool operator>=( const bigstream_t<S> &lhs, const bigstream_t<S> &rhs ) 		{ return lhs._cmp(rhs)>=0; }
+
+template <ssize_t S>
+MATHCALL inline bool operator<( const bigstream_t<S> &lhs, const bigstream_t<S> &rhs ) 		{ return lhs._cmp(rhs)<0;  }
+
+template <ssize_t S>
+MATHCALL inline bool operator<=( const bigstream_t<S> &lhs, const bigstream_t<S> &rhs ) 		{ return lhs._cmp(rhs)<=0; }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator+( bigstream_t<S> lhs, const bigstream_t<S> &rhs ) 		{ lhs+=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator-( bigstream_t<S> lhs, const bigstream_t<S> &rhs ) 		{ lhs-=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator*( bigstream_t<S> lhs, const bigstream_t<S> &rhs ) 		{ lhs*=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator&( bigstream_t<S> lhs, const bigstream_t<S> &rhs ) 		{ lhs&=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator|( bigstream_t<S> lhs, const bigstream_t<S> &rhs ) 		{ lhs|=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator^( bigstream_t<S> lhs, const bigstream_t<S> &rhs ) 		{ lhs^=rhs; return(lhs); }
+
+
+//standard integer overloads
+
+template <ssize_t S>
+MATHCALL inline bool operator!=( const bigstream_t<S> &lhs, const int rhs ) 					{ return !lhs._eq(bigstream_t<S>(rhs)); }
+
+template <ssize_t S>
+MATHCALL inline bool operator==( const bigstream_t<S> &lhs, const int rhs ) 					{ return lhs._eq(bigstream_t<S>(rhs));  }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator+( bigstream_t<S> lhs, const int rhs ) 					{ lhs+=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator-( bigstream_t<S> lhs, const int rhs ) 					{ lhs-=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator*( bigstream_t<S> lhs, const int rhs ) 					{ lhs*=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator*( const int lhs, bigstream_t<S> rhs ) 					{ rhs*=lhs; return(rhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator<<( bigstream_t<S> lhs, const int rhs ) 				{ lhs<<=rhs; return(lhs); }
+
+template <ssize_t S>
+MATHCALL inline bigstream_t<S> operator>>( bigstream_t<S> lhs, const int rhs ) 				{ lhs>>=rhs; return(lhs); }
+
+
+#endif
@@ -69,7 +69,7 @@ struct linkbase
 
 	linkitem<T> *m_first, *m_last;
 
-	inline linkbase() : m_first(0), m_last() {}
+	constexpr linkbase() : m_first(0), m_last() {}
 
 	inline void reset() { m_first = 0; }
 
@@ -179,7 +179,7 @@ struct linkbase_single
 
 	linkitem_single<T> *m_last;
 
-	inline linkbase_single() : m_last(0) {}
+	constexpr linkbase_single() : m_last(0) {}
 
 	inline void reset() { m_last = 0; }
 